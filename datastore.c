@@ -17,12 +17,14 @@
 
 #include "datastore.h"
 #include "datastoreBufferPool.h"
+#include "datastoreCoalesce.h"
+#include "datastoreRing.h"
 #include "datastoreUtil.h"
+#include "datastoreWaiter.h"
 
 /* Setting module logging */
 LOG_MODULE_REGISTER(DATASTORE_LOGGER_NAME);
 
-#define DATASTORE_STACK_SIZE                                    (256)
 #define DATASTORE_RESPONSE_TIMEOUT                              (5)
 
 /**
@@ -34,133 +36,1813 @@ typedef enum
 {
   DATASTORE_READ = 0,
   DATASTORE_WRITE,
+  DATASTORE_WRITE_POOLED,
+  DATASTORE_READ_BATCH,
+  DATASTORE_READ_CHANGES,
+  DATASTORE_WRITE_COALESCED,
+  DATASTORE_MODIFY,
+  DATASTORE_TXN,
+  DATASTORE_COMMIT,
+  DATASTORE_BULK_BEGIN,
+  DATASTORE_WRITE_BATCH,
+  DATASTORE_BULK_END,
   DATASTORE_MSG_TYPE_COUNT,
 } datastoreMsgtype_t;
 
+#define DATASTORE_MSG_TYPE_BITS                                 (4)
+#define DATASTORE_MSG_DATAPOINT_TYPE_BITS                       (3)
+#define DATASTORE_MSG_DATAPOINT_ID_BITS                         (12)
+#define DATASTORE_MSG_VAL_COUNT_BITS                            (12)
+
+BUILD_ASSERT(DATASTORE_MSG_TYPE_COUNT <= BIT(DATASTORE_MSG_TYPE_BITS), "too many message types");
+BUILD_ASSERT(DATAPOINT_TYPE_COUNT <= BIT(DATASTORE_MSG_DATAPOINT_TYPE_BITS), "too many datapoint types");
+
+typedef struct
+{
+  uint32_t msgType : DATASTORE_MSG_TYPE_BITS;
+  uint32_t datapointType : DATASTORE_MSG_DATAPOINT_TYPE_BITS;
+  uint32_t datapointId : DATASTORE_MSG_DATAPOINT_ID_BITS;
+  uint32_t valCount : DATASTORE_MSG_VAL_COUNT_BITS;
+  uint32_t isAsync : 1;
+  union
+  {
+    DatapointData_t *values;
+    DatastoreReadDesc_t *descs;
+    DatastoreWriteDesc_t *writeDescs;
+    DatastoreChangeQuery_t *query;
+    DatastoreTxn_t *txn;
+    uint32_t slotId;
+    DatapointData_t inlineValues[DATASTORE_MSG_INLINE_VALUES];
+    struct
+    {
+      DatapointData_t operand;
+      DatapointData_t expected;
+      DatapointData_t *oldValue;
+      uint32_t op;
+    } rmw;
+  };
+  union
+  {
+    struct k_msgq *response;
+    DatastoreAsync_t *async;
+  };
+} DatastoreMsg_t;
+
+BUILD_ASSERT(DATASTORE_MSG_TYPE_BITS + DATASTORE_MSG_DATAPOINT_TYPE_BITS + DATASTORE_MSG_DATAPOINT_ID_BITS +
+             DATASTORE_MSG_VAL_COUNT_BITS + 1 <= 32, "the message header must fit in a word");
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+/**
+ * @brief   The notification work queue.
+ */
+static struct k_work_q notifyWorkQueue;
+
+/**
+ * @brief   The deferred notification work.
+ */
+static struct k_work notifyWork;
+
+/**
+ * @brief   The initial notifications done flag.
+ */
+static atomic_t isInitNotified = ATOMIC_INIT(false);
+#else
+/**
+ * @brief   The service thread.
+ */
+static struct k_thread thread;
+#endif
+
+/**
+ * @brief   The ISR write record.
+ */
 typedef struct
 {
-  datastoreMsgtype_t msgType;
-  DatapointType_t datapointType;
-  uint32_t datapointId;
-  DatapointData_t *values;
-  size_t valCount;
-  struct K_msgq *response;
-} DatastoreMsg_t;
+  uint32_t datapointType : DATASTORE_MSG_DATAPOINT_TYPE_BITS;
+  uint32_t datapointId : DATASTORE_MSG_DATAPOINT_ID_BITS;
+  uint32_t valCount : DATASTORE_MSG_VAL_COUNT_BITS;
+  DatapointData_t values[DATASTORE_ISR_MAX_VALUES];
+} DatastoreIsrWrite_t;
+
+/**
+ * @brief   The service thread doorbell.
+ */
+DATASTORE_DOORBELL_DEFINE(datastoreDoorbell);
+
+#if DATASTORE_MPSC_INGRESS_ENABLED
+/**
+ * @brief   The urgent lane ingress ring.
+ */
+DATASTORE_RING_DEFINE(datastoreUrgentRing, sizeof(DatastoreMsg_t), DATASTORE_URGENT_RING_SLOT_COUNT, &datastoreDoorbell);
+
+/**
+ * @brief   The bulk lane ingress ring.
+ */
+DATASTORE_RING_DEFINE(datastoreRing, sizeof(DatastoreMsg_t), DATASTORE_RING_SLOT_COUNT, &datastoreDoorbell);
+
+/**
+ * @brief   The ingress ring of each lane.
+ */
+static DatastoreRing_t *laneRings[DATASTORE_LANE_COUNT] = {[DATASTORE_LANE_URGENT] = &datastoreUrgentRing,
+                                                           [DATASTORE_LANE_BULK] = &datastoreRing};
+#else
+K_MSGQ_DEFINE(datastoreUrgentQueue, sizeof(DatastoreMsg_t), DATASTORE_URGENT_MSG_COUNT, 4);
+K_MSGQ_DEFINE(datastoreQueue, sizeof(DatastoreMsg_t), DATASTORE_MSG_COUNT, 4);
+
+/**
+ * @brief   The ingress queue of each lane.
+ */
+static struct k_msgq *laneQueues[DATASTORE_LANE_COUNT] = {[DATASTORE_LANE_URGENT] = &datastoreUrgentQueue,
+                                                          [DATASTORE_LANE_BULK] = &datastoreQueue};
+
+/**
+ * @brief   The lane queue head lock, taken to get a message from a lane queue.
+ */
+static struct k_spinlock laneHeadLock;
+
+/**
+ * @brief   The service thread wait events, a message in any lane or the doorbell.
+ */
+static struct k_poll_event ingressEvents[] = {
+  K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &datastoreUrgentQueue, 0),
+  K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &datastoreQueue, 0),
+  K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &datastoreDoorbell.sem, 0),
+};
+#endif
+
+/**
+ * @brief   The capacity of each lane.
+ */
+#if DATASTORE_MPSC_INGRESS_ENABLED
+static const uint32_t laneDepths[DATASTORE_LANE_COUNT] = {[DATASTORE_LANE_URGENT] = DATASTORE_URGENT_RING_SLOT_COUNT,
+                                                          [DATASTORE_LANE_BULK] = DATASTORE_RING_SLOT_COUNT};
+#else
+static const uint32_t laneDepths[DATASTORE_LANE_COUNT] = {[DATASTORE_LANE_URGENT] = DATASTORE_URGENT_MSG_COUNT,
+                                                          [DATASTORE_LANE_BULK] = DATASTORE_MSG_COUNT};
+#endif
+
+/**
+ * @brief   The count of messages queued in each lane.
+ */
+static atomic_t lanePutCounts[DATASTORE_LANE_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   The count of messages refused by each full lane.
+ */
+static atomic_t laneFullCounts[DATASTORE_LANE_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   The highest count of messages seen waiting in each lane.
+ */
+static uint32_t laneMaxUsed[DATASTORE_LANE_COUNT] = {0};
+
+/**
+ * @brief   The count of writes dropped by each backpressure policy.
+ */
+static atomic_t policyDropCounts[DATASTORE_POLICY_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   The count of writes that waited for room with each backpressure policy.
+ */
+static atomic_t policyWaitCounts[DATASTORE_POLICY_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   The count of writes merged with a pending write by each backpressure policy.
+ */
+static atomic_t policyMergeCounts[DATASTORE_POLICY_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   The ISR write ring.
+ */
+DATASTORE_RING_DEFINE(datastoreIsrRing, sizeof(DatastoreIsrWrite_t), DATASTORE_ISR_RING_SLOT_COUNT, &datastoreDoorbell);
+
+/**
+ * @brief   The count of ISR writes dropped because the ring was full.
+ */
+static atomic_t isrOverflowCount = ATOMIC_INIT(0);
+
+/**
+ * @brief   The pool of the write buffers too large to be inlined.
+ */
+static DatastoreBufferPool_t *writePool;
+
+/**
+ * @brief   Check if the message header fields can hold the datapoint type, ID and count.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The values count.
+ *
+ * @return  true if they fit, false otherwise.
+ */
+static inline bool isMsgHeaderValid(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+  return datapointType < DATAPOINT_TYPE_COUNT && datapointId < BIT(DATASTORE_MSG_DATAPOINT_ID_BITS) &&
+         valCount < BIT(DATASTORE_MSG_VAL_COUNT_BITS);
+}
+
+/**
+ * @brief   Check if the message header count field can hold the descriptors count.
+ *
+ * @param[in]   descCount: The descriptors count.
+ *
+ * @return  true if it fits, false otherwise.
+ */
+static inline bool isMsgBatchValid(size_t descCount)
+{
+  return descCount > 0 && descCount < BIT(DATASTORE_MSG_VAL_COUNT_BITS);
+}
+
+/**
+ * @brief   Check the batch read descriptors.
+ *
+ * @param[in]   descs: The read descriptors.
+ * @param[in]   descCount: The descriptors count.
+ *
+ * @return  true if all are valid, false otherwise.
+ */
+static bool areReadDescsValid(const DatastoreReadDesc_t descs[], size_t descCount)
+{
+  if(!descs || !isMsgBatchValid(descCount))
+    return false;
+
+  for(size_t i = 0; i < descCount; ++i)
+  {
+    if(!descs[i].values || !isMsgHeaderValid(descs[i].datapointType, descs[i].datapointId, descs[i].valCount))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Check if a write must be rejected because its range is owned.
+ *
+ * @note    Checked again by the service thread, a claim can land while the
+ *          write is queued.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The values count.
+ *
+ * @return  true if the write must be rejected, false otherwise.
+ */
+static inline bool isOwnedWriteRejected(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+  return datastoreUtilIsRangeOwned(datapointType, datapointId, valCount);
+}
+
+/**
+ * @brief   Validate a write in the caller context, before it is queued.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values (NULL, to only check the range).
+ * @param[in]   valCount: The values count.
+ *
+ * @return  0 if valid, the error code otherwise.
+ */
+static inline int validateWrite(DatapointType_t datapointType, uint32_t datapointId,
+                                const DatapointData_t values[], size_t valCount)
+{
+  int err;
+
+  err = datastoreUtilValidateWrite(datapointType, datapointId, values, valCount);
+  if(err < 0)
+    return err;
+
+  if(isOwnedWriteRejected(datapointType, datapointId, valCount))
+    return -EPERM;
+
+  return 0;
+}
+
+/**
+ * @brief   Check if writes wait to be applied or processed outside of the ingress.
+ *
+ * @return  true if ISR or owner writes are pending, false otherwise.
+ */
+static inline bool hasDeferredWrites(void)
+{
+  return !datastoreRingIsEmpty(&datastoreIsrRing) || datastoreUtilHasOwnedChanges();
+}
+
+/**
+ * @brief   Build a write message, the values are copied inline or into a pool buffer.
+ *
+ * @param[out]  msg: The message.
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values.
+ * @param[in]   valCount: The values count.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int buildWriteMsg(DatastoreMsg_t *msg, DatapointType_t datapointType, uint32_t datapointId,
+                         DatapointData_t values[], size_t valCount)
+{
+  if(!values || valCount == 0 || !isMsgHeaderValid(datapointType, datapointId, valCount))
+    return -EINVAL;
+
+  msg->datapointType = datapointType;
+  msg->datapointId = datapointId;
+  msg->valCount = valCount;
+
+  if(valCount <= DATASTORE_MSG_INLINE_VALUES)
+  {
+    msg->msgType = DATASTORE_WRITE;
+    memcpy(msg->inlineValues, values, valCount * sizeof(DatapointData_t));
+    return 0;
+  }
+
+  if(!writePool || valCount > writePool->bufferSize)
+    return -EMSGSIZE;
+
+  msg->values = datastoreBufPoolGet(writePool);
+  if(!msg->values)
+    return -ENOMEM;
+
+  msg->msgType = DATASTORE_WRITE_POOLED;
+  memcpy(msg->values, values, valCount * sizeof(DatapointData_t));
+
+  return 0;
+}
+
+/**
+ * @brief   Release the pool buffer of a message, if it owns one.
+ *
+ * @param[in]   msg: The message.
+ */
+static void releaseMsgBuffer(DatastoreMsg_t *msg)
+{
+  int err;
+
+  if(msg->msgType != DATASTORE_WRITE_POOLED)
+    return;
+
+  err = datastoreBufPoolReturn(writePool, msg->values);
+  if(err < 0)
+    LOG_ERR("ERROR %d: unable to return the write buffer", err);
+}
+
+/**
+ * @brief   Get the lane set by the flags of a datapoint.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ *
+ * @return  The lane.
+ */
+static inline DatastoreLane_t getDatapointLane(DatapointType_t datapointType, uint32_t datapointId)
+{
+  if(datastoreUtilGetFlags(datapointType, datapointId) & DATAPOINT_FLAG_URGENT_MASK)
+    return DATASTORE_LANE_URGENT;
+
+  return DATASTORE_LANE_BULK;
+}
+
+/**
+ * @brief   Get the count of messages waiting in a lane.
+ *
+ * @param[in]   lane: The lane.
+ *
+ * @return  The count of messages.
+ */
+static inline uint32_t getLaneUsedCount(DatastoreLane_t lane)
+{
+#if DATASTORE_MPSC_INGRESS_ENABLED
+  return datastoreRingUsedCount(laneRings[lane]);
+#else
+  return k_msgq_num_used_get(laneQueues[lane]);
+#endif
+}
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+static void processMessage(DatastoreMsg_t *msg);
+#endif
+
+/**
+ * @brief   Put a message in a lane of the service ingress.
+ *
+ * @note    In direct write mode the message is processed in the caller
+ *          context, the lane only counts it.
+ *
+ * @param[in]   msg: The message.
+ * @param[in]   lane: The lane.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static inline int ingressPut(DatastoreMsg_t *msg, DatastoreLane_t lane)
+{
+  int err;
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  processMessage(msg);
+  err = 0;
+#elif DATASTORE_MPSC_INGRESS_ENABLED
+  err = datastoreRingPut(laneRings[lane], msg);
+#else
+  err = k_msgq_put(laneQueues[lane], msg, K_NO_WAIT);
+#endif
+  atomic_inc(err == 0 ? lanePutCounts + lane : laneFullCounts + lane);
+
+  return err;
+}
+
+/**
+ * @brief   Complete a request.
+ *
+ * @param[in]   msg: The request message.
+ * @param[in]   status: The request status.
+ */
+static void completeRequest(DatastoreMsg_t *msg, int status)
+{
+  if(!msg->isAsync)
+  {
+    if(msg->response)
+      k_msgq_put(msg->response, &status, K_NO_WAIT);
+  }
+  else if(msg->async)
+  {
+    msg->async->status = status;
+
+    if(msg->async->callback)
+      msg->async->callback(status, msg->async->userData);
+
+    if(msg->async->work)
+      k_work_submit(msg->async->work);
+
+    if(msg->async->signal)
+      k_poll_signal_raise(msg->async->signal, status);
+  }
+}
+
+/**
+ * @brief   Get the backpressure policy set by the flags of a datapoint.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ *
+ * @return  The policy.
+ */
+static inline DatastorePolicy_t getDatapointPolicy(DatapointType_t datapointType, uint32_t datapointId)
+{
+  uint32_t flags = datastoreUtilGetFlags(datapointType, datapointId);
+
+  return DATASTORE_POLICY_DROP_NEWEST + ((flags & DATAPOINT_FLAG_POLICY_MASK) >> DATAPOINT_FLAG_POLICY_SHIFT);
+}
+
+/**
+ * @brief   Drop a request without processing it.
+ *
+ * @param[in]   msg: The request message.
+ */
+static void discardMessage(DatastoreMsg_t *msg)
+{
+  if(msg->msgType == DATASTORE_WRITE_COALESCED)
+    datastoreCoalesceDiscard(msg->slotId);
+
+  releaseMsgBuffer(msg);
+  completeRequest(msg, -ECANCELED);
+}
+
+/**
+ * @brief   Drop the oldest message of a lane if it is a plain write.
+ *
+ * @note    The ring has a single consumer, only the message queues support it.
+ *          A queue only gives its head, the oldest write is dropped only when
+ *          it is the head. A read or control message is never dropped.
+ *
+ * @param[in]   lane: The lane.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int dropOldest(DatastoreLane_t lane)
+{
+#if DATASTORE_MPSC_INGRESS_ENABLED
+  ARG_UNUSED(lane);
+  return -ENOTSUP;
+#else
+  int err;
+  k_spinlock_key_t key;
+  DatastoreMsg_t oldest;
+
+  /* The head must not change between the peek and the get, the service thread takes the same lock. */
+  key = k_spin_lock(&laneHeadLock);
+
+  err = k_msgq_peek(laneQueues[lane], &oldest);
+  if(err == 0)
+  {
+    if(oldest.msgType == DATASTORE_WRITE || oldest.msgType == DATASTORE_WRITE_POOLED ||
+       oldest.msgType == DATASTORE_WRITE_COALESCED)
+      k_msgq_get(laneQueues[lane], &oldest, K_NO_WAIT);
+    else
+      err = -EBUSY;
+  }
+
+  k_spin_unlock(&laneHeadLock, key);
+
+  if(err == -EBUSY)
+    return err;
+
+  /* The service thread may have emptied the lane meanwhile, there is room then. */
+  if(err == 0)
+    discardMessage(&oldest);
+
+  return 0;
+#endif
+}
+
+/**
+ * @brief   Put a message in a lane, waiting for room until a timeout.
+ *
+ * @param[in]   msg: The message.
+ * @param[in]   lane: The lane.
+ * @param[in]   timeout: The wait timeout.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int ingressPutWait(DatastoreMsg_t *msg, DatastoreLane_t lane, k_timeout_t timeout)
+{
+#if DATASTORE_MPSC_INGRESS_ENABLED
+  int err;
+  k_timepoint_t end = sys_timepoint_calc(timeout);
+
+  /* The ring producers never block, poll for room once per tick. */
+  do
+  {
+    k_sleep(K_TICKS(1));
+
+    err = datastoreRingPut(laneRings[lane], msg);
+  } while(err == -ENOMSG && !sys_timepoint_expired(end));
+
+  return err;
+#else
+  return k_msgq_put(laneQueues[lane], msg, timeout);
+#endif
+}
+
+/**
+ * @brief   Stop coalescing the pending writes overlapping a request.
+ *
+ * @note    The ring ingress skips the coalescing, its producers stay lock-free.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of values.
+ */
+static inline void sealPendingWrites(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+#if DATASTORE_COALESCE_ENABLED
+  datastoreCoalesceSeal(datapointType, datapointId, valCount);
+#else
+  ARG_UNUSED(datapointType);
+  ARG_UNUSED(datapointId);
+  ARG_UNUSED(valCount);
+#endif
+}
+
+/**
+ * @brief   Merge a write message with a pending write of the same datapoints.
+ *
+ * @param[in]   msg: The write message.
+ *
+ * @return  0 if merged, the error code otherwise.
+ */
+static int mergeWriteMsg(DatastoreMsg_t *msg)
+{
+#if DATASTORE_COALESCE_ENABLED
+  if(msg->msgType != DATASTORE_WRITE && msg->msgType != DATASTORE_WRITE_POOLED)
+    return -ENOTSUP;
+
+  /* A merged write is never processed on its own, only a fire-and-forget write can be. */
+  if(msg->isAsync || msg->response)
+    return -ENOTSUP;
+
+  /* Every event must be delivered, an event write is never merged. */
+  if(datastoreUtilHasEvents(msg->datapointType, msg->datapointId, msg->valCount))
+    return -ENOTSUP;
+
+  /* The lane is full, a new slot could not be queued either: only merge with a queued one. */
+  return datastoreCoalesceWrite(msg->datapointType, msg->datapointId,
+                                msg->msgType == DATASTORE_WRITE ? msg->inlineValues : msg->values,
+                                msg->valCount, NULL);
+#else
+  ARG_UNUSED(msg);
+  return -ENOTSUP;
+#endif
+}
+
+/**
+ * @brief   Put a write message in a lane, applying a backpressure policy if the lane is full.
+ *
+ * @param[in]   msg: The message.
+ * @param[in]   lane: The lane.
+ * @param[in]   policy: The backpressure policy.
+ * @param[in]   timeout: The wait timeout of the blocking policy.
+ *
+ * @return  0 if queued, 1 if merged with a pending write, the error code otherwise.
+ */
+static int ingressPutWithPolicy(DatastoreMsg_t *msg, DatastoreLane_t lane, DatastorePolicy_t policy,
+                                k_timeout_t timeout)
+{
+  int err;
+
+  err = ingressPut(msg, lane);
+  if(err != -ENOMSG)
+    return err;
+
+  switch(policy)
+  {
+    case DATASTORE_POLICY_BLOCK:
+      if(k_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT))
+        break;
+
+      atomic_inc(policyWaitCounts + policy);
+      err = ingressPutWait(msg, lane, timeout);
+    break;
+    case DATASTORE_POLICY_DROP_OLDEST:
+      err = dropOldest(lane);
+      if(err == 0)
+        err = ingressPut(msg, lane);
+      else
+        err = -ENOMSG;
+    break;
+    case DATASTORE_POLICY_COALESCE:
+      if(mergeWriteMsg(msg) == 0)
+      {
+        releaseMsgBuffer(msg);
+        atomic_inc(policyMergeCounts + policy);
+        return 1;
+      }
+    break;
+    default:
+    break;
+  }
+
+  if(err < 0)
+    atomic_inc(policyDropCounts + policy);
+
+  return err;
+}
+
+/**
+ * @brief   Submit a write message and wait for its response, if any.
+ *
+ * @note    The message pool buffer, if any, is released on failure.
+ *
+ * @param[in]   msg: The write message.
+ * @param[in]   lane: The lane.
+ * @param[in]   policy: The backpressure policy.
+ * @param[in]   timeout: The wait timeout of the blocking policy.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int submitWriteMsg(DatastoreMsg_t *msg, DatastoreLane_t lane, DatastorePolicy_t policy, k_timeout_t timeout)
+{
+  int err;
+  int resStatus = 0;
+
+  err = ingressPutWithPolicy(msg, lane, policy, timeout);
+  if(err < 0)
+  {
+    releaseMsgBuffer(msg);
+    return err;
+  }
+
+  if(err == 1)
+    return 0;
+
+  /* Sealed once queued, the caller next write can no longer jump ahead of this one. */
+  sealPendingWrites(msg->datapointType, msg->datapointId, msg->valCount);
+
+  if(msg->response)
+  {
+    err = k_msgq_get(msg->response, &resStatus, K_MSEC(DATASTORE_RESPONSE_TIMEOUT));
+    if(err < 0)
+      return err;
+  }
+
+  return resStatus;
+}
+
+#if !DATASTORE_DIRECT_WRITE_ENABLED
+/**
+ * @brief   Get the next message from the service ingress if there is one.
+ *
+ * @note    The urgent lane is always emptied first.
+ *
+ * @param[out]  msg: The message.
+ *
+ * @return  0 if successful, -ENOMSG if the ingress is empty.
+ */
+static int ingressTryGet(DatastoreMsg_t *msg)
+{
+  int err;
+  uint32_t used;
+#if !DATASTORE_MPSC_INGRESS_ENABLED
+  k_spinlock_key_t key;
+#endif
+
+  for(uint32_t lane = DATASTORE_LANE_URGENT; lane < DATASTORE_LANE_COUNT; ++lane)
+  {
+    used = getLaneUsedCount(lane);
+    if(used == 0)
+      continue;
+
+    laneMaxUsed[lane] = MAX(laneMaxUsed[lane], used);
+
+#if DATASTORE_MPSC_INGRESS_ENABLED
+    err = datastoreRingGet(laneRings[lane], msg);
+#else
+    key = k_spin_lock(&laneHeadLock);
+    err = k_msgq_get(laneQueues[lane], msg, K_NO_WAIT);
+    k_spin_unlock(&laneHeadLock, key);
+#endif
+    if(err == 0)
+      return 0;
+  }
+
+  return -ENOMSG;
+}
+
+/**
+ * @brief   Check if the service ingress is empty.
+ *
+ * @return  true if empty, false otherwise.
+ */
+static inline bool isIngressEmpty(void)
+{
+  for(uint32_t lane = DATASTORE_LANE_URGENT; lane < DATASTORE_LANE_COUNT; ++lane)
+  {
+    if(getLaneUsedCount(lane) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Get the next message from the service ingress, wait if there is none.
+ *
+ * @note    The wait also ends when an ISR or owner write is pending.
+ *
+ * @param[out]  msg: The message.
+ *
+ * @return  0 if successful, -EAGAIN if ISR or owner writes are pending, the error code otherwise.
+ */
+static int ingressGet(DatastoreMsg_t *msg)
+{
+  int err;
+
+  for(;;)
+  {
+    if(ingressTryGet(msg) == 0)
+      return 0;
+
+    if(hasDeferredWrites())
+      return -EAGAIN;
+
+    /* Arm before checking again, a producer publishing in between rings the doorbell. */
+    datastoreDoorbellArm(&datastoreDoorbell);
+
+    if(!isIngressEmpty() || hasDeferredWrites())
+    {
+      datastoreDoorbellCancel(&datastoreDoorbell);
+      continue;
+    }
+
+#if DATASTORE_MPSC_INGRESS_ENABLED
+    err = datastoreDoorbellWait(&datastoreDoorbell, K_FOREVER);
+#else
+    err = k_poll(ingressEvents, ARRAY_SIZE(ingressEvents), K_FOREVER);
+
+    /* Woken by a message the doorbell is still armed, a pending ring is simply consumed. */
+    datastoreDoorbellCancel(&datastoreDoorbell);
+    k_sem_take(&datastoreDoorbell.sem, K_NO_WAIT);
+    for(size_t i = 0; i < ARRAY_SIZE(ingressEvents); ++i)
+      ingressEvents[i].state = K_POLL_STATE_NOT_READY;
+#endif
+    if(err < 0)
+      return err;
+  }
+}
+#endif
+
+/**
+ * @brief   Apply the pending ISR writes and notify the subscribers once.
+ *
+ * @note    At most one ring worth of writes is applied, the queued requests
+ *          are not held back by an ISR writing faster than the drain.
+ */
+static void drainIsrWrites(void)
+{
+  int err;
+  bool needToNotify = false;
+  bool isWriteChanged;
+  DatastoreIsrWrite_t write;
+
+  for(size_t i = 0; i < DATASTORE_ISR_RING_SLOT_COUNT; ++i)
+  {
+    if(datastoreRingGet(&datastoreIsrRing, &write) < 0)
+      break;
+
+    err = datastoreUtilWriteData(write.datapointType, write.datapointId, write.values, write.valCount,
+                                 &isWriteChanged, NULL);
+    if(err < 0)
+    {
+      LOG_ERR("ERROR %d: unable to apply an ISR write", err);
+      continue;
+    }
+
+    needToNotify = needToNotify || isWriteChanged;
+  }
+
+  if(needToNotify)
+  {
+    err = datastoreUtilNotify();
+    if(err)
+      LOG_ERR("ERROR %d: unable to notify", err);
+  }
+}
+
+/**
+ * @brief   Process the owner writes and notify the subscribers once.
+ */
+static void drainOwnedWrites(void)
+{
+  int err;
+  bool needToNotify;
+
+  datastoreUtilProcessOwnedChanges(&needToNotify);
+
+  if(needToNotify)
+  {
+    err = datastoreUtilNotify();
+    if(err)
+      LOG_ERR("ERROR %d: unable to notify", err);
+  }
+}
+
+/**
+ * @brief   Notify the subscribers of the changed datapoints.
+ *
+ * @note    In direct write mode the notification pass is deferred to the
+ *          notification work queue.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static inline int notifySubscribers(void)
+{
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  int err = k_work_submit_to_queue(&notifyWorkQueue, &notifyWork);
+
+  return err < 0 ? err : 0;
+#else
+  return datastoreUtilNotify();
+#endif
+}
+
+/**
+ * @brief   Write values and notify the subscribers if they changed.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values.
+ * @param[in]   valCount: The values count.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int processWrite(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t values[], size_t valCount)
+{
+  int err;
+  bool needToNotify = false;
+
+  err = datastoreUtilWriteData(datapointType, datapointId, values, valCount, &needToNotify, NULL);
+
+  if(err == 0 && needToNotify)
+  {
+    err = notifySubscribers();
+    if(err)
+      LOG_ERR("ERROR %d: unable to notify", err);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Read, modify and write a value and notify the subscribers if it changed.
+ *
+ * @param[in]   msg: The modify message.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int processModify(DatastoreMsg_t *msg)
+{
+  int err;
+  int errNotify;
+  bool needToNotify = false;
+
+  err = datastoreUtilModifyData(msg->datapointType, msg->datapointId, msg->rmw.op, msg->rmw.operand,
+                                msg->rmw.expected, msg->rmw.oldValue, &needToNotify);
+
+  if(err == 0 && needToNotify)
+  {
+    errNotify = notifySubscribers();
+    if(errNotify)
+    {
+      err = errNotify;
+      LOG_ERR("ERROR %d: unable to notify", err);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Write the staged values of a transaction and notify the subscribers once.
+ *
+ * @param[in]   txn: The transaction.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int processTransaction(DatastoreTxn_t *txn)
+{
+  int err;
+  bool needToNotify = false;
+
+  err = datastoreUtilWriteTransaction(txn, &needToNotify);
+
+  /* Even a failed transaction notifies the writes applied before the failure. */
+  if(needToNotify)
+  {
+    int errNotify = notifySubscribers();
+    if(errNotify)
+    {
+      err = err ? err : errNotify;
+      LOG_ERR("ERROR %d: unable to notify", errNotify);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Apply a list of writes and notify the subscribers once.
+ *
+ * @param[in]   descs: The write descriptors.
+ * @param[in]   descCount: The write descriptor count.
+ *
+ * @return  0 if successful, the error code of the last failed write otherwise.
+ */
+static int processWriteBatch(DatastoreWriteDesc_t descs[], size_t descCount)
+{
+  int err = 0;
+  int errWrite;
+  bool needToNotify = false;
+  bool isWriteChanged;
+
+  for(size_t i = 0; i < descCount; ++i)
+  {
+    errWrite = datastoreUtilWriteData(descs[i].datapointType, descs[i].datapointId, descs[i].values,
+                                      descs[i].valCount, &isWriteChanged, NULL);
+    if(errWrite < 0)
+    {
+      err = errWrite;
+      LOG_ERR("ERROR %d: unable to apply bulk write %zu", err, i);
+      continue;
+    }
+
+    needToNotify = needToNotify || isWriteChanged;
+  }
+
+  if(needToNotify)
+  {
+    errWrite = notifySubscribers();
+    if(errWrite)
+    {
+      err = err ? err : errWrite;
+      LOG_ERR("ERROR %d: unable to notify", errWrite);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   End a bulk apply session, notify the subscribers if it was the outermost one.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int processBulkEnd(void)
+{
+  int err;
+
+  err = datastoreUtilResumeNotify();
+  if(err <= 0)
+    return err;
+
+  err = notifySubscribers();
+  if(err)
+    LOG_ERR("ERROR %d: unable to notify", err);
+
+  return err;
+}
+
+/**
+ * @brief   Write the latest values of a coalesced write.
+ *
+ * @param[in]   slotId: The pending write slot ID.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int processCoalescedWrite(uint32_t slotId)
+{
+  int err;
+  DatapointType_t datapointType;
+  uint32_t datapointId;
+  size_t valCount;
+  DatapointData_t values[DATASTORE_COALESCE_MAX_VALUES];
+
+  err = datastoreCoalesceTake(slotId, &datapointType, &datapointId, values, &valCount);
+  if(err < 0)
+    return err;
+
+  return processWrite(datapointType, datapointId, values, valCount);
+}
+
+/**
+ * @brief   Process a request message.
+ *
+ * @param[in]   msg: The request message.
+ */
+static void processMessage(DatastoreMsg_t *msg)
+{
+  int errOp;
+
+  switch(msg->msgType)
+  {
+    case DATASTORE_READ:
+      errOp = datastoreUtilReadData(msg->datapointType, msg->datapointId, msg->valCount, msg->values);
+    break;
+    case DATASTORE_READ_BATCH:
+      errOp = datastoreUtilReadBatch(msg->descs, msg->valCount);
+    break;
+    case DATASTORE_READ_CHANGES:
+      errOp = datastoreUtilReadChanges(msg->query);
+    break;
+    case DATASTORE_WRITE:
+      errOp = processWrite(msg->datapointType, msg->datapointId, msg->inlineValues, msg->valCount);
+    break;
+    case DATASTORE_WRITE_POOLED:
+      errOp = processWrite(msg->datapointType, msg->datapointId, msg->values, msg->valCount);
+      releaseMsgBuffer(msg);
+    break;
+    case DATASTORE_WRITE_COALESCED:
+      errOp = processCoalescedWrite(msg->slotId);
+    break;
+    case DATASTORE_MODIFY:
+      errOp = processModify(msg);
+    break;
+    case DATASTORE_TXN:
+      errOp = processTransaction(msg->txn);
+    break;
+    case DATASTORE_COMMIT:
+      errOp = 0;
+    break;
+    case DATASTORE_BULK_BEGIN:
+      datastoreUtilSuspendNotify();
+      errOp = 0;
+    break;
+    case DATASTORE_WRITE_BATCH:
+      errOp = processWriteBatch(msg->writeDescs, msg->valCount);
+    break;
+    case DATASTORE_BULK_END:
+      errOp = processBulkEnd();
+    break;
+    default:
+      errOp = -ENOTSUP;
+      LOG_WRN("unsupported message type %d", msg->msgType);
+    break;
+  }
+
+  completeRequest(msg, errOp);
+}
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+/**
+ * @brief   The deferred notification work handler.
+ *
+ * @note    The first pass also makes the initial notifications.
+ *
+ * @param[in]   work: The notification work.
+ */
+static void notifyWorkHandler(struct k_work *work)
+{
+  int err;
+
+  ARG_UNUSED(work);
+
+  if(!atomic_set(&isInitNotified, true))
+  {
+    err = datastoreUtilDoInitNotifications();
+    if(err < 0)
+      LOG_ERR("ERROR %d: unable to make initial notifications", err);
+  }
+
+  drainIsrWrites();
+  drainOwnedWrites();
+
+  err = datastoreUtilNotify();
+  if(err)
+    LOG_ERR("ERROR %d: unable to notify", err);
+}
+#else
+/**
+ * @brief   The datastore service thread function.
+ *
+ * @param[in]   p1: Thread first parameter.
+ * @param[in]   p2: Thread second parameter.
+ * @param[in]   p3: Thread third parameter.
+ */
+static void run(void *p1, void *p2, void *p3)
+{
+  int err;
+  DatastoreMsg_t msg;
+
+  // TODO: Initialize the datapoints from the NVM.
+
+  err = datastoreUtilDoInitNotifications();
+  if(err < 0)
+    LOG_ERR("ERROR %d: unable to make initial notifications", err);
+
+  for(;;)
+  {
+    drainIsrWrites();
+    drainOwnedWrites();
+
+    err = ingressGet(&msg);
+    if(err == 0)
+      processMessage(&msg);
+    else if(err != -EAGAIN)
+      LOG_ERR("ERROR %d: unable to get a message", err);
+
+    err = datastoreUtilCommitSnapshot();
+    if(err < 0 && err != -EBUSY)
+      LOG_ERR("ERROR %d: unable to commit the snapshot", err);
+  }
+}
+#endif
+
+int datastoreInit(size_t maxSubs[DATAPOINT_TYPE_COUNT], size_t maxBufferSize, uint32_t priority, k_tid_t *threadId)
+{
+  int err;
+
+  for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; ++i)
+  {
+    err = datastoreUtilAllocateSubs(i, maxSubs[i]);
+    if(err < 0)
+      return err;
+  }
+
+  err = datastoreUtilInitBufferPool(maxSubs);
+  if(err < 0)
+    return err;
+
+  err = datastoreUtilInitDatapoints();
+  if(err < 0)
+    return err;
+
+#if DATASTORE_MPSC_INGRESS_ENABLED
+  for(uint32_t lane = DATASTORE_LANE_URGENT; lane < DATASTORE_LANE_COUNT; ++lane)
+    datastoreRingInit(laneRings[lane]);
+#endif
+  datastoreRingInit(&datastoreIsrRing);
+
+  if(maxBufferSize > DATASTORE_MSG_INLINE_VALUES)
+  {
+    writePool = datastoreBufPoolInit(maxBufferSize, DATASTORE_WRITE_POOL_COUNT);
+    if(!writePool)
+      return -ENOSPC;
+  }
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  k_work_queue_init(&notifyWorkQueue);
+  k_work_queue_start(&notifyWorkQueue, datastoreStack, K_THREAD_STACK_SIZEOF(datastoreStack),
+                     K_PRIO_PREEMPT(priority), NULL);
+  k_work_init(&notifyWork, notifyWorkHandler);
+  *threadId = k_work_queue_thread_get(&notifyWorkQueue);
+
+  err = k_thread_name_set(*threadId, "datastore");
+  if(err < 0)
+    LOG_ERR("ERROR %d: unable to set datastore thread name", err);
+
+  /* No service thread start to hook on, the initial notifications are deferred right away. */
+  k_work_submit_to_queue(&notifyWorkQueue, &notifyWork);
+
+  return 0;
+#else
+  *threadId = k_thread_create(&thread, datastoreStack, DATASTORE_STACK_SIZE, run,
+                              NULL, NULL, NULL, K_PRIO_PREEMPT(priority), 0, K_FOREVER);
+
+  err = k_thread_name_set(*threadId, "datastore");
+  if(err < 0)
+    LOG_ERR("ERROR %d: unable to set datastore thread name", err);
+
+  return err;
+#endif
+}
+
+int datastoreRead(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                  struct k_msgq *response, DatapointData_t values[])
+{
+  int err;
+  int resStatus = 0;
+  DatastoreMsg_t msg = {.msgType = DATASTORE_READ, .datapointType = datapointType, .datapointId = datapointId,
+                        .values = values, .valCount = valCount, .response = response };
+
+  if(!isMsgHeaderValid(datapointType, datapointId, valCount))
+    return -EINVAL;
+
+  err = ingressPut(&msg, getDatapointLane(datapointType, datapointId));
+  if(err < 0)
+    return err;
+
+  err = k_msgq_get(response, &resStatus, K_MSEC(DATASTORE_RESPONSE_TIMEOUT));
+  if(err < 0)
+    return err;
+
+  return resStatus;
+}
+
+int datastoreReadBatch(DatastoreReadDesc_t descs[], size_t descCount, struct k_msgq *response)
+{
+  int err;
+  int resStatus = 0;
+  DatastoreMsg_t msg = {.msgType = DATASTORE_READ_BATCH, .descs = descs, .valCount = descCount, .response = response};
+
+  if(!response || !areReadDescsValid(descs, descCount))
+    return -EINVAL;
+
+  err = ingressPut(&msg, DATASTORE_LANE_BULK);
+  if(err < 0)
+    return err;
+
+  err = k_msgq_get(response, &resStatus, K_MSEC(DATASTORE_RESPONSE_TIMEOUT));
+  if(err < 0)
+    return err;
+
+  return resStatus;
+}
+
+int datastoreWriteFromIsr(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t values[], size_t valCount)
+{
+  int err;
+  DatastoreIsrWrite_t write;
+
+  if(!values || valCount == 0 || !isMsgHeaderValid(datapointType, datapointId, valCount))
+    return -EINVAL;
+
+  if(valCount > DATASTORE_ISR_MAX_VALUES)
+    return -EMSGSIZE;
+
+  err = validateWrite(datapointType, datapointId, values, valCount);
+  if(err < 0)
+    return err;
+
+  write.datapointType = datapointType;
+  write.datapointId = datapointId;
+  write.valCount = valCount;
+  memcpy(write.values, values, valCount * sizeof(DatapointData_t));
+
+  err = datastoreRingPut(&datastoreIsrRing, &write);
+  if(err < 0)
+  {
+    atomic_inc(&isrOverflowCount);
+    return err;
+  }
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  k_work_submit_to_queue(&notifyWorkQueue, &notifyWork);
+#endif
+
+  return 0;
+}
+
+uint32_t datastoreButtonEventOverflowCount(uint32_t datapointId)
+{
+  return datastoreUtilGetEventOverflowCount(datapointId);
+}
+
+uint32_t datastoreIsrOverflowCount(void)
+{
+  return atomic_get(&isrOverflowCount);
+}
+
+int datastoreGetPolicyStats(DatastorePolicy_t policy, DatastorePolicyStats_t *stats)
+{
+  if(policy == DATASTORE_POLICY_DEFAULT || policy >= DATASTORE_POLICY_COUNT || !stats)
+    return -EINVAL;
+
+  stats->dropCount = atomic_get(policyDropCounts + policy);
+  stats->waitCount = atomic_get(policyWaitCounts + policy);
+  stats->mergeCount = atomic_get(policyMergeCounts + policy);
+
+  return 0;
+}
+
+int datastoreGetLaneStats(DatastoreLane_t lane, DatastoreLaneStats_t *stats)
+{
+  if(lane == DATASTORE_LANE_DEFAULT || lane >= DATASTORE_LANE_COUNT || !stats)
+    return -EINVAL;
+
+  stats->depth = laneDepths[lane];
+  stats->used = getLaneUsedCount(lane);
+  stats->maxUsed = laneMaxUsed[lane];
+  stats->putCount = atomic_get(lanePutCounts + lane);
+  stats->fullCount = atomic_get(laneFullCounts + lane);
+
+  return 0;
+}
+
+int datastoreWaitFor(DatapointType_t datapointType, uint32_t datapointId, DatastoreWaitCond_t cond,
+                     DatapointData_t value, k_timeout_t timeout)
+{
+  return datastoreWaiterWait(datapointType, datapointId, cond, value, timeout);
+}
 
-/**
- * @brief   The service thread.
- */
-static k_thread thread;
+int datastoreReadChanges(DatastoreChangeQuery_t *query, struct k_msgq *response)
+{
+  int err;
+  int resStatus = 0;
+  DatastoreMsg_t msg = {.msgType = DATASTORE_READ_CHANGES, .query = query, .response = response};
 
-K_MSGQ_DEFINE(datastoreQueue, sizeof(DatastoreMsg_t), DATASTORE_MSG_COUNT, 4);
+  if(!query || !query->ids || !query->values || !response)
+    return -EINVAL;
 
-/**
- * @brief   The datastore service thread function.
- *
- * @param[in]   p1: Thread first parameter.
- * @param[in]   p2: Thread second parameter.
- * @param[in]   p3: Thread third parameter.
- */
-static void run(void *p1, void *p2, void *p3)
+  err = ingressPut(&msg, DATASTORE_LANE_BULK);
+  if(err < 0)
+    return err;
+
+  err = k_msgq_get(response, &resStatus, K_MSEC(DATASTORE_RESPONSE_TIMEOUT));
+  if(err < 0)
+    return err;
+
+  return resStatus;
+}
+
+const DatastoreSnapshot_t *datastoreSnapshotAcquire(void)
+{
+  return datastoreUtilAcquireSnapshot();
+}
+
+void datastoreSnapshotRelease(const DatastoreSnapshot_t *snapshot)
+{
+  DatastoreMsg_t msg = {.msgType = DATASTORE_COMMIT};
+
+  /* Wake the service thread for the commit deferred by this snapshot, a full queue commits soon anyway. */
+  if(datastoreUtilReleaseSnapshot(snapshot))
+    ingressPut(&msg, DATASTORE_LANE_BULK);
+}
+
+int datastoreReadAsync(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                       DatapointData_t values[], DatastoreAsync_t *async)
+{
+  DatastoreMsg_t msg = {.msgType = DATASTORE_READ, .datapointType = datapointType, .datapointId = datapointId,
+                        .values = values, .valCount = valCount, .isAsync = true, .async = async};
+
+  if(!async || !isMsgHeaderValid(datapointType, datapointId, valCount))
+    return -EINVAL;
+
+  return ingressPut(&msg, getDatapointLane(datapointType, datapointId));
+}
+
+int datastoreReadBatchAsync(DatastoreReadDesc_t descs[], size_t descCount, DatastoreAsync_t *async)
+{
+  DatastoreMsg_t msg = {.msgType = DATASTORE_READ_BATCH, .descs = descs, .valCount = descCount, .isAsync = true,
+                        .async = async};
+
+  if(!async || !areReadDescsValid(descs, descCount))
+    return -EINVAL;
+
+  return ingressPut(&msg, DATASTORE_LANE_BULK);
+}
+
+int datastoreReadDirect(DatapointType_t datapointType, uint32_t datapointId, size_t valCount, DatapointData_t values[])
+{
+  return datastoreUtilReadDataDirect(datapointType, datapointId, valCount, values, NULL);
+}
+
+int datastoreReadTimestamped(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                             DatapointData_t values[], uint32_t timestamps[])
+{
+  if(!timestamps)
+    return -EINVAL;
+
+  return datastoreUtilReadDataDirect(datapointType, datapointId, valCount, values, timestamps);
+}
+
+int datastoreCountOlderThan(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                            uint32_t maxAge, size_t *staleCount)
+{
+  if(!staleCount)
+    return -EINVAL;
+
+  return datastoreUtilCountOlderThan(datapointType, datapointId, valCount, maxAge, staleCount);
+}
+
+int datastoreWrite(DatapointType_t datapointType, uint32_t datapointId,
+                   DatapointData_t values[], size_t valCount, struct k_msgq *response)
+{
+  return datastoreWriteWithOptions(datapointType, datapointId, values, valCount, NULL, response);
+}
+
+int datastoreWriteWithOptions(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t values[],
+                              size_t valCount, const DatastoreWriteOptions_t *options, struct k_msgq *response)
 {
   int err;
-  int errOp;
-  bool needToNotify = false;
-  DatastoreMsg_t msg;
+  DatastoreLane_t lane;
+  DatastorePolicy_t policy;
+  k_timeout_t timeout = K_MSEC(DATASTORE_BLOCK_TIMEOUT);
+  DatastoreMsg_t msg = {.response = response};
 
-  // TODO: Initialize the datapoints from the NVM.
+  if(!values || valCount == 0)
+    return -EINVAL;
 
-  err = datastoreUtilNotifyFloat();
+  err = validateWrite(datapointType, datapointId, values, valCount);
   if(err < 0)
-    LOG_ERR("ERROR %d: unable to make initial notifications", err);
+    return err;
 
-  for(;;)
+  lane = getDatapointLane(datapointType, datapointId);
+  policy = getDatapointPolicy(datapointType, datapointId);
+
+  if(options && options->lane != DATASTORE_LANE_DEFAULT && options->lane < DATASTORE_LANE_COUNT)
+    lane = options->lane;
+
+  if(options && options->policy != DATASTORE_POLICY_DEFAULT && options->policy < DATASTORE_POLICY_COUNT)
   {
-    err = k_msgq_get(&datastoreQueue, &msg, K_FOREVER);
-    if(err < 0)
-    {
-      LOG_ERR("ERROR %d: unable to get a message", err);
-      continue;
-    }
+    policy = options->policy;
+    timeout = options->timeout;
+  }
 
-    switch(msg.msgType)
+#if DATASTORE_COALESCE_ENABLED
+  if(!response && !datastoreUtilHasEvents(datapointType, datapointId, valCount))
+  {
+    uint32_t slotId;
+
+    err = datastoreCoalesceWrite(datapointType, datapointId, values, valCount, &slotId);
+    if(err == 0)
+      return 0;
+
+    if(err == 1)
     {
-      case DATASTORE_READ:
-        errOp = datastoreUtilRead(msg.datapointType, msg.datapointId, msg.valCount, msg.values);
-      break;
-      case DATASTORE_WRITE:
-        errOp = datastoreUtilWrite(msg.datapointType, msg.datapointId, msg.values, msg.valCount, &needToNotify);
-
-        if(errOp == 0 && needToNotify)
-        {
-          err = datastoreUtilNotify(msg.datapointType, msg.datapointId);
-          if(err)
-            LOG_ERR("ERROR %d: unable to notify", err);
-        }
-      break;
-      default:
-        LOG_WRN("unsupported message type %d", msg.msgType);
-      break;
+      DatastoreMsg_t coalescedMsg = {.msgType = DATASTORE_WRITE_COALESCED, .slotId = slotId};
+
+      err = ingressPutWithPolicy(&coalescedMsg, lane, policy, timeout);
+      if(err < 0)
+        datastoreCoalesceCancel(slotId);
+      else
+        datastoreCoalescePublish(slotId);
+
+      return err;
     }
+  }
+#endif
+
+  err = buildWriteMsg(&msg, datapointType, datapointId, values, valCount);
+  if(err < 0)
+    return err;
+
+  return submitWriteMsg(&msg, lane, policy, timeout);
+}
+
+int datastoreWriteAsync(DatapointType_t datapointType, uint32_t datapointId,
+                        DatapointData_t values[], size_t valCount, DatastoreAsync_t *async)
+{
+  int err;
+  DatastoreMsg_t msg = {.isAsync = true, .async = async};
+
+  if(!async || !values)
+    return -EINVAL;
+
+  err = validateWrite(datapointType, datapointId, values, valCount);
+  if(err < 0)
+    return err;
+
+  err = buildWriteMsg(&msg, datapointType, datapointId, values, valCount);
+  if(err < 0)
+    return err;
+
+  sealPendingWrites(datapointType, datapointId, valCount);
+
+  err = ingressPut(&msg, getDatapointLane(datapointType, datapointId));
+  if(err < 0)
+    releaseMsgBuffer(&msg);
+
+  return err;
+}
+
+DatapointData_t *datastoreWriteBufferGet(void)
+{
+  if(!writePool)
+    return NULL;
+
+  return datastoreBufPoolGet(writePool);
+}
+
+int datastoreWriteBufferCommit(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t *buffer,
+                               size_t valCount, struct k_msgq *response)
+{
+  int err;
+  DatastoreMsg_t msg = {.msgType = DATASTORE_WRITE_POOLED, .values = buffer, .response = response};
+
+  if(!buffer)
+    return -EINVAL;
+
+  if(!writePool || valCount == 0 || valCount > writePool->bufferSize ||
+     !isMsgHeaderValid(datapointType, datapointId, valCount))
+  {
+    datastoreWriteBufferRelease(buffer);
+    return -EINVAL;
+  }
 
-    if(msg.response)
-      k_msgq_put(msg.response, &errOp, K_NO_WAIT);
+  err = validateWrite(datapointType, datapointId, buffer, valCount);
+  if(err < 0)
+  {
+    datastoreWriteBufferRelease(buffer);
+    return err;
   }
+
+  msg.datapointType = datapointType;
+  msg.datapointId = datapointId;
+  msg.valCount = valCount;
+
+  return submitWriteMsg(&msg, getDatapointLane(datapointType, datapointId),
+                        getDatapointPolicy(datapointType, datapointId), K_MSEC(DATASTORE_BLOCK_TIMEOUT));
 }
 
-int datastoreInit(size_t maxSubs[DATAPOINT_TYPE_COUNT], size_t maxBufferSize, uint32_t priority, k_tid_t *threadId)
+int datastoreWriteBufferRelease(DatapointData_t *buffer)
+{
+  if(!writePool || !buffer)
+    return -EINVAL;
+
+  return datastoreBufPoolReturn(writePool, buffer);
+}
+
+int datastoreOwnerClaim(DatastoreOwner_t *owner, DatapointType_t datapointType, uint32_t datapointId,
+                        size_t valCount)
 {
   int err;
 
-  for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; ++i)
+  if(!owner || valCount == 0)
+    return -EINVAL;
+
+  /* The snapshot commit moves the working bank under the owner feet. */
+  if(DATASTORE_SNAPSHOT_ENABLED)
+    return -ENOTSUP;
+
+  /* An owner write skips the event rings, every event must be queued by the service. */
+  if(datastoreUtilHasEvents(datapointType, datapointId, valCount))
+    return -ENOTSUP;
+
+  err = datastoreUtilClaimRange(datapointType, datapointId, valCount);
+  if(err < 0)
   {
-    err = datastoreUtilAllocateSubs(i, maxSubs[i]);
-    if(err < 0)
-      return err;
+    LOG_ERR("ERROR %d: unable to claim %zu datapoints of type %d from %d", err, valCount, datapointType, datapointId);
+    return err;
   }
 
-  err = datastoreUtilInitBufferPool(maxSubs);
+  owner->datapointType = datapointType;
+  owner->datapointId = datapointId;
+  owner->valCount = valCount;
+  owner->thread = k_current_get();
+
+  return 0;
+}
+
+void datastoreOwnerRelease(DatastoreOwner_t *owner)
+{
+  if(!owner || owner->valCount == 0)
+    return;
+
+  datastoreUtilReleaseRange(owner->datapointType, owner->datapointId, owner->valCount);
+  owner->valCount = 0;
+}
+
+int datastoreOwnerWrite(DatastoreOwner_t *owner, uint32_t datapointId, DatapointData_t values[], size_t valCount)
+{
+  int err;
+
+  if(!owner || !values || valCount == 0 || datapointId < owner->datapointId ||
+     datapointId - owner->datapointId + valCount > owner->valCount)
+    return -EINVAL;
+
+  if(DATASTORE_OWNER_CHECK_ENABLED && owner->thread != k_current_get())
+    return -EPERM;
+
+  err = datastoreUtilValidateWrite(owner->datapointType, datapointId, values, valCount);
   if(err < 0)
     return err;
 
-  *threadId = k_thread_create(&thread, datastoreStack, DATASTORE_STACK_SIZE, run,
-                              NULL, NULL, NULL, K_PRIO_PREEMPT(priority), 0, K_FOREVER);
+  if(!datastoreUtilWriteOwnedData(owner->datapointType, datapointId, values, valCount))
+    return 0;
 
-  err = k_thread_name_set(*threadId, "datastore");
-  if(err< 0)
-    LOG_ERR("ERROR %d: unable to set datastore thread name", err)
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  k_work_submit_to_queue(&notifyWorkQueue, &notifyWork);
+#else
+  datastoreDoorbellRing(&datastoreDoorbell);
+#endif
 
-  return err;
+  return 0;
 }
 
-int datastoreRead(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
-                  struct k_msgq *response, Datapoint_t values[])
+void datastoreTxnBegin(DatastoreTxn_t *txn)
+{
+  txn->writeCount = 0;
+  txn->valCount = 0;
+  txn->status = 0;
+}
+
+int datastoreTxnStage(DatastoreTxn_t *txn, DatapointType_t datapointType, uint32_t datapointId,
+                      DatapointData_t values[], size_t valCount)
+{
+  int err = 0;
+  DatastoreTxnWrite_t *write;
+
+  if(!txn)
+    return -EINVAL;
+
+  if(!values || valCount == 0)
+    err = -EINVAL;
+  else if(txn->writeCount >= DATASTORE_TXN_MAX_WRITES || valCount > DATASTORE_TXN_MAX_VALUES - txn->valCount)
+    err = -ENOSPC;
+  else
+    err = validateWrite(datapointType, datapointId, values, valCount);
+
+  if(err < 0)
+  {
+    if(txn->status == 0)
+      txn->status = err;
+
+    return err;
+  }
+
+  write = txn->writes + txn->writeCount;
+  write->datapointType = datapointType;
+  write->datapointId = datapointId;
+  write->valCount = valCount;
+  write->valOffset = txn->valCount;
+
+  memcpy(txn->values + txn->valCount, values, valCount * sizeof(DatapointData_t));
+
+  txn->valCount += valCount;
+  ++txn->writeCount;
+
+  return 0;
+}
+
+int datastoreTxnCommit(DatastoreTxn_t *txn, struct k_msgq *response)
 {
   int err;
   int resStatus = 0;
-  DatastoreMsg_t msg = {.msgType = DATASTORE_READ, .datapointType = datapointType, .datapointId = datapointId,
-                        .values = values, .valCount = valCount, .response = response };
+  DatastoreMsg_t msg = {.msgType = DATASTORE_TXN, .txn = txn, .response = response};
+
+  if(!txn || !response)
+    return -EINVAL;
 
-  err = k_msgq_put(&datastoreQueue, &msg, K_NO_WAIT);
+  if(txn->status < 0)
+    return txn->status;
+
+  if(txn->writeCount == 0)
+    return 0;
+
+  /* Later writes must not be merged ahead of the transaction. */
+  for(size_t i = 0; i < txn->writeCount; ++i)
+    sealPendingWrites(txn->writes[i].datapointType, txn->writes[i].datapointId, txn->writes[i].valCount);
+
+  err = ingressPut(&msg, DATASTORE_LANE_BULK);
   if(err < 0)
     return err;
 
-  err = k_msgq_get(response, &resStatus, K_MSEC(DATASTORE_RESPONSE_TIMEOUT));
+  /* Once queued, the service thread reads the transaction in place, a timeout would let it be reused. */
+  err = k_msgq_get(response, &resStatus, K_FOREVER);
   if(err < 0)
     return err;
 
   return resStatus;
 }
 
-int datastoreWrite(DatapointType_t datapointType, uint32_t datapointId,
-                   Datapoint_t values[], size_t valCount, struct k_msgq *response)
+/**
+ * @brief   Queue a bulk apply request and wait for its response.
+ *
+ * @note    Once queued, the request is always waited for: the service thread
+ *          reads the caller descriptors in place and a session marker must
+ *          never be reported as failed while it is still to be applied.
+ *
+ * @param[in]   msg: The request message.
+ * @param[in]   session: The session opened or closed by the request (NULL, if none).
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int submitBulkMsg(DatastoreMsg_t *msg, DatastoreBulkSession_t *session)
 {
   int err;
   int resStatus = 0;
-  DatastoreMsg_t msg = {.msgType = DATASTORE_WRITE, .datapointType = datapointType, .datapointId = datapointId,
-                        .values = values, .valCount = valCount, .response = response };
 
-  err = k_msgq_put(&datastoreQueue, &msg, K_NO_WAIT);
+  err = ingressPutWithPolicy(msg, DATASTORE_LANE_BULK, DATASTORE_POLICY_BLOCK, K_MSEC(DATASTORE_BLOCK_TIMEOUT));
+  if(err < 0)
+  {
+    /* Never queued, the session goes back to its previous state. */
+    if(session)
+      atomic_set(&session->isOpen, msg->msgType == DATASTORE_BULK_END);
+
+    return err;
+  }
+
+  err = k_msgq_get(msg->response, &resStatus, K_FOREVER);
+  if(err < 0)
+    return err;
+
+  return resStatus;
+}
+
+int datastoreBulkBegin(DatastoreBulkSession_t *session, struct k_msgq *response)
+{
+  DatastoreMsg_t msg = {.msgType = DATASTORE_BULK_BEGIN, .response = response};
+
+  if(!session || !response)
+    return -EINVAL;
+
+  if(!atomic_cas(&session->isOpen, false, true))
+    return -EALREADY;
+
+  return submitBulkMsg(&msg, session);
+}
+
+int datastoreBulkApply(DatastoreWriteDesc_t descs[], size_t descCount, struct k_msgq *response)
+{
+  int err;
+  DatastoreMsg_t msg = {.msgType = DATASTORE_WRITE_BATCH, .writeDescs = descs, .valCount = descCount,
+                        .response = response};
+
+  if(!descs || !response || !isMsgBatchValid(descCount))
+    return -EINVAL;
+
+  for(size_t i = 0; i < descCount; ++i)
+  {
+    if(!descs[i].values || descs[i].valCount == 0)
+      return -EINVAL;
+
+    err = validateWrite(descs[i].datapointType, descs[i].datapointId, descs[i].values, descs[i].valCount);
+    if(err < 0)
+      return err;
+  }
+
+  /* Later writes must not be merged ahead of the bulk writes. */
+  for(size_t i = 0; i < descCount; ++i)
+    sealPendingWrites(descs[i].datapointType, descs[i].datapointId, descs[i].valCount);
+
+  return submitBulkMsg(&msg, NULL);
+}
+
+int datastoreBulkEnd(DatastoreBulkSession_t *session, struct k_msgq *response)
+{
+  DatastoreMsg_t msg = {.msgType = DATASTORE_BULK_END, .response = response};
+
+  if(!session || !response)
+    return -EINVAL;
+
+  if(!atomic_cas(&session->isOpen, true, false))
+    return -EALREADY;
+
+  return submitBulkMsg(&msg, session);
+}
+
+int datastoreModify(DatapointType_t datapointType, uint32_t datapointId, DatastoreRmwOp_t op,
+                    DatapointData_t operand, DatapointData_t expected, DatapointData_t *oldValue,
+                    struct k_msgq *response)
+{
+  int err;
+  int resStatus = 0;
+  DatastoreMsg_t msg = {.msgType = DATASTORE_MODIFY, .datapointType = datapointType, .datapointId = datapointId,
+                        .valCount = 1, .response = response};
+
+  if(op >= DATASTORE_RMW_OP_COUNT || (oldValue && !response) || !isMsgHeaderValid(datapointType, datapointId, 1))
+    return -EINVAL;
+
+  err = validateWrite(datapointType, datapointId, NULL, 1);
+  if(err < 0)
+    return err;
+
+  msg.rmw.op = op;
+  msg.rmw.operand = operand;
+  msg.rmw.expected = expected;
+  msg.rmw.oldValue = oldValue;
+
+  /* A later write must not be merged ahead of this operation. */
+  sealPendingWrites(datapointType, datapointId, 1);
+
+  err = ingressPut(&msg, getDatapointLane(datapointType, datapointId));
   if(err < 0)
     return err;
 
@@ -176,152 +1858,182 @@ int datastoreWrite(DatapointType_t datapointType, uint32_t datapointId,
 
 int datastoreSubscribeBinary(DatastoreBinarySub_t *sub)
 {
-  return dataStoreUtilAddSubscription(DATAPOINT_BINARY, sub);
+  return datastoreUtilAddSubscription(DATAPOINT_BINARY, (GenericSubscription_t *)sub);
 }
 
 int datastorePauseSubBinary(DatastoreBinarySubCb_t subCallback)
 {
-  return datastoreUtilPauseSubscription(DATAPOINT_BINARY, (NotifierCallback_t)subCallback);
+  return datastoreUtilPauseSubscription(DATAPOINT_BINARY, (GenericCallback_t)subCallback);
 }
 
 int datastoreUnpauseSubBinary(DatastoreBinarySubCb_t subCallback)
 {
-  return datastoreUtilUnpauseSubscription(DATAPOINT_BINARY, (NotifierCallback_t)subCallback);
+  return datastoreUtilUnpauseSubscription(DATAPOINT_BINARY, (GenericCallback_t)subCallback);
 }
 
 int datastoreReadBinary(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[])
 {
-  return datastoreRead(DATAPOINT_BINARY, datapointId, valCount, response, (Datapoint_t *)values);
+  return datastoreRead(DATAPOINT_BINARY, datapointId, valCount, response, (DatapointData_t *)values);
+}
+
+int datastoreReadBinaryDirect(uint32_t datapointId, size_t valCount, uint32_t values[])
+{
+  return datastoreReadDirect(DATAPOINT_BINARY, datapointId, valCount, (DatapointData_t *)values);
 }
 
 int datastoreWriteBinary(uint32_t datapointId, uint32_t values[], size_t valCount, struct k_msgq *response)
 {
-  return datastoreWrite(DATAPOINT_BINARY, datapointId, (Datapoint_t *)values, valCount, response);
+  return datastoreWrite(DATAPOINT_BINARY, datapointId, (DatapointData_t *)values, valCount, response);
 }
 
 int datastoreSubscribeButton(DatastoreButtonSub_t *sub)
 {
-  return dataStoreUtilAddSubscription(DATAPOINT_BUTTON, sub);
+  return datastoreUtilAddSubscription(DATAPOINT_BUTTON, (GenericSubscription_t *)sub);
 }
 
 int datastorePauseSubButton(DatastoreButtonSubCb_t subCallback)
 {
-  return datastoreUtilPauseSubscription(DATAPOINT_BUTTON, (NotifierCallback_t)subCallback);
+  return datastoreUtilPauseSubscription(DATAPOINT_BUTTON, (GenericCallback_t)subCallback);
 }
 
 int datastoreUnpauseSubButton(DatastoreButtonSubCb_t subCallback)
 {
-  return datastoreUtilUnpauseSubscription(DATAPOINT_BUTTON, (NotifierCallback_t)subCallback);
+  return datastoreUtilUnpauseSubscription(DATAPOINT_BUTTON, (GenericCallback_t)subCallback);
 }
 
 int datastoreReadButton(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[])
 {
-  return datastoreRead(DATAPOINT_BUTTON, datapointId, valCount, response, (Datapoint_t *)values);
+  return datastoreRead(DATAPOINT_BUTTON, datapointId, valCount, response, (DatapointData_t *)values);
+}
+
+int datastoreReadButtonDirect(uint32_t datapointId, size_t valCount, uint32_t values[])
+{
+  return datastoreReadDirect(DATAPOINT_BUTTON, datapointId, valCount, (DatapointData_t *)values);
 }
 
 int datastoreWriteButton(uint32_t datapointId, uint32_t values[], size_t valCount, struct k_msgq *response)
 {
-  return datastoreWrite(DATAPOINT_BUTTON, datapointId, (Datapoint_t *)values, valCount, response);
+  return datastoreWrite(DATAPOINT_BUTTON, datapointId, (DatapointData_t *)values, valCount, response);
 }
 
 int datastoreSubscribeFloat(DatastoreFloatSub_t *sub)
 {
-  return dataStoreUtilAddSubscription(DATAPOINT_FLOAT, sub);
+  return datastoreUtilAddSubscription(DATAPOINT_FLOAT, (GenericSubscription_t *)sub);
 }
 
 int datastorePauseSubFloat(DatastoreFloatSubCb_t subCallback)
 {
-  return datastoreUtilPauseSubscription(DATAPOINT_FLOAT, (NotifierCallback_t)subCallback);
+  return datastoreUtilPauseSubscription(DATAPOINT_FLOAT, (GenericCallback_t)subCallback);
 }
 
 int datastoreUnpauseSubFloat(DatastoreFloatSubCb_t subCallback)
 {
-  return datastoreUtilUnpauseSubscription(DATAPOINT_FLOAT, (NotifierCallback_t)subCallback)
+  return datastoreUtilUnpauseSubscription(DATAPOINT_FLOAT, (GenericCallback_t)subCallback);
 }
 
 int datastoreReadFloat(uint32_t datapointId, size_t valCount, struct k_msgq *response, float values[])
 {
-  return datastoreRead(DATAPOINT_FLOAT, datapointId, valCount, response, (Datapoint_t *)values);
+  return datastoreRead(DATAPOINT_FLOAT, datapointId, valCount, response, (DatapointData_t *)values);
+}
+
+int datastoreReadFloatDirect(uint32_t datapointId, size_t valCount, float values[])
+{
+  return datastoreReadDirect(DATAPOINT_FLOAT, datapointId, valCount, (DatapointData_t *)values);
 }
 
 int datastoreWriteFloat(uint32_t datapointId, float values[], size_t valCount, struct k_msgq *response)
 {
-  return datastoreWrite(DATAPOINT_FLOAT, datapointId, (Datapoint_t *)values, valCount, response);
+  return datastoreWrite(DATAPOINT_FLOAT, datapointId, (DatapointData_t *)values, valCount, response);
 }
 
 int datastoreSubscribeInt(DatastoreIntSub_t *sub)
 {
-  return dataStoreUtilAddSubscription(DATAPOINT_INT, sub);
+  return datastoreUtilAddSubscription(DATAPOINT_INT, (GenericSubscription_t *)sub);
 }
 
 int datastorePauseSubInt(DatastoreIntSubCb_t subCallback)
 {
-  return datastoreUtilPauseSubscription(DATAPOINT_INT, (NotifierCallback_t)subCallback);
+  return datastoreUtilPauseSubscription(DATAPOINT_INT, (GenericCallback_t)subCallback);
 }
 
 int datastoreUnpauseSubInt(DatastoreIntSubCb_t subCallback)
 {
-  return datastoreUtilUnpauseSubscription(DATAPOINT_INT, (NotifierCallback_t)subCallback);
+  return datastoreUtilUnpauseSubscription(DATAPOINT_INT, (GenericCallback_t)subCallback);
 }
 
 int datastoreReadInt(uint32_t datapointId, size_t valCount, struct k_msgq *response, int32_t values[])
 {
-  return datastoreRead(DATAPOINT_INT, datapointId, valCount, response, (Datapoint_t *)values);
+  return datastoreRead(DATAPOINT_INT, datapointId, valCount, response, (DatapointData_t *)values);
+}
+
+int datastoreReadIntDirect(uint32_t datapointId, size_t valCount, int32_t values[])
+{
+  return datastoreReadDirect(DATAPOINT_INT, datapointId, valCount, (DatapointData_t *)values);
 }
 
 int datastoreWriteInt(uint32_t datapointId, int32_t values[], size_t valCount, struct k_msgq *response)
 {
-  return datastoreWrite(DATAPOINT_INT, datapointId, (Datapoint_t *)values, valCount, response);
+  return datastoreWrite(DATAPOINT_INT, datapointId, (DatapointData_t *)values, valCount, response);
 }
 
 int datastoreSubscribeMultiState(DatastoreMultiStateSub_t *sub)
 {
-  return dataStoreUtilAddSubscription(DATAPOINT_MULTI_STATE, sub);
+  return datastoreUtilAddSubscription(DATAPOINT_MULTI_STATE, (GenericSubscription_t *)sub);
 }
 
 int datastorePauseSubMultiState(DatastoreMultiStateSubCb_t subCallback)
 {
-  return datastoreUtilPauseSubscription(DATAPOINT_MULTI_STATE, (NotifierCallback_t)subCallback);
+  return datastoreUtilPauseSubscription(DATAPOINT_MULTI_STATE, (GenericCallback_t)subCallback);
 }
 
 int datastoreUnpauseSubMultiState(DatastoreMultiStateSubCb_t subCallback)
 {
-  return datastoreUtilUnpauseSubscription(DATAPOINT_MULTI_STATE, (NotifierCallback_t)subCallback);
+  return datastoreUtilUnpauseSubscription(DATAPOINT_MULTI_STATE, (GenericCallback_t)subCallback);
 }
 
 int datastoreReadMultiState(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[])
 {
-  return datastoreRead(DATAPOINT_MULTI_STATE, datapointId, valCount, response, (Datapoint_t *)values);
+  return datastoreRead(DATAPOINT_MULTI_STATE, datapointId, valCount, response, (DatapointData_t *)values);
+}
+
+int datastoreReadMultiStateDirect(uint32_t datapointId, size_t valCount, uint32_t values[])
+{
+  return datastoreReadDirect(DATAPOINT_MULTI_STATE, datapointId, valCount, (DatapointData_t *)values);
 }
 
 int datastoreWriteMultiState(uint32_t datapointId, uint32_t values[], size_t valCount, struct k_msgq *response)
 {
-  return datastoreWrite(DATAPOINT_MULTI_STATE, datapointId, (Datapoint_t *)values, valCount, response);
+  return datastoreWrite(DATAPOINT_MULTI_STATE, datapointId, (DatapointData_t *)values, valCount, response);
 }
 
 int datastoreSubscribeUint(DatastoreUintSub_t *sub)
 {
-  return dataStoreUtilAddSubscription(DATAPOINT_UINT, sub);
+  return datastoreUtilAddSubscription(DATAPOINT_UINT, (GenericSubscription_t *)sub);
 }
 
 int datastorePauseSubUint(DatastoreUintSubCb_t subCallback)
 {
-  return datastoreUtilPauseSubscription(DATAPOINT_UINT, (NotifierCallback_t)subCallback);
+  return datastoreUtilPauseSubscription(DATAPOINT_UINT, (GenericCallback_t)subCallback);
 }
 
 int datastoreUnpauseSubUint(DatastoreUintSubCb_t subCallback)
 {
-  return datastoreUtilUnpauseSubscription(DATAPOINT_UINT, (NotifierCallback_t)subCallback);
+  return datastoreUtilUnpauseSubscription(DATAPOINT_UINT, (GenericCallback_t)subCallback);
 }
 
 int datastoreReadUint(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[])
 {
-  return datastoreRead(DATAPOINT_UINT, datapointId, valCount, response, (Datapoint_t *)values);
+  return datastoreRead(DATAPOINT_UINT, datapointId, valCount, response, (DatapointData_t *)values);
+}
+
+int datastoreReadUintDirect(uint32_t datapointId, size_t valCount, uint32_t values[])
+{
+  return datastoreReadDirect(DATAPOINT_UINT, datapointId, valCount, (DatapointData_t *)values);
 }
 
 int datastoreWriteUint(uint32_t datapointId, uint32_t values[], size_t valCount, struct k_msgq *response)
 {
-  return datastoreWrite(DATAPOINT_UINT, datapointId, (Datapoint_t *)values, valCount, response);
+  return datastoreWrite(DATAPOINT_UINT, datapointId, (DatapointData_t *)values, valCount, response);
 }
 
 /** @} */
@@ -26,9 +26,9 @@
  */
 enum BinaryDatapoint
 {
-#define X(name, flags, defaultVal) name,
+#define X(name, flags, defaultVal, band, minVal, maxVal) name,
   DATASTORE_BINARY_DATAPOINTS
-#undef
+#undef X
   BINARY_DATAPOINT_COUNT,
 };
 
@@ -38,9 +38,9 @@ enum BinaryDatapoint
  */
 enum ButtonDatapoint
 {
-#define X(name, flags, defaultVal) name,
+#define X(name, flags, defaultVal, band, minVal, maxVal) name,
   DATASTORE_BUTTON_DATAPOINTS
-#undef
+#undef X
   BUTTON_DATAPOINT_COUNT,
 };
 
@@ -50,9 +50,9 @@ enum ButtonDatapoint
  */
 enum FloatDatapoint
 {
-#define X(name, flags, defaultVal) name,
+#define X(name, flags, defaultVal, band, minVal, maxVal) name,
   DATASTORE_FLOAT_DATAPOINTS
-#undef
+#undef X
   FLOAT_DATAPOINT_COUNT,
 };
 
@@ -62,9 +62,9 @@ enum FloatDatapoint
  */
 enum IntDatapoint
 {
-#define X(name, flags, defaultVal) name,
+#define X(name, flags, defaultVal, band, minVal, maxVal) name,
   DATASTORE_INT_DATAPOINTS
-#undef
+#undef X
   INT_DATAPOINT_COUNT,
 };
 
@@ -74,9 +74,9 @@ enum IntDatapoint
  */
 enum MultiStateDatapoint
 {
-#define X(name, flags, defaultVal) name,
+#define X(name, flags, defaultVal, band, minVal, maxVal) name,
   DATASTORE_MULTI_STATE_DATAPOINTS
-#undef
+#undef X
   MULTI_STATE_DATAPOINT_COUNT,
 };
 
@@ -86,12 +86,197 @@ enum MultiStateDatapoint
  */
 enum UintDatapoint
 {
-#define X(name, flags, defaultVal) name,
+#define X(name, flags, defaultVal, band, minVal, maxVal) name,
   DATASTORE_UINT_DATAPOINTS
-#undef
+#undef X
   UINT_DATAPOINT_COUNT,
 };
 
+/**
+ * @brief   The datastore snapshot, every datapoint of every type.
+ */
+typedef struct
+{
+  DatapointData_t binaries[BINARY_DATAPOINT_COUNT];         /**< The binary datapoints */
+  DatapointData_t buttons[BUTTON_DATAPOINT_COUNT];          /**< The button datapoints */
+  DatapointData_t floats[FLOAT_DATAPOINT_COUNT];            /**< The float datapoints */
+  DatapointData_t ints[INT_DATAPOINT_COUNT];                /**< The signed integer datapoints */
+  DatapointData_t multiStates[MULTI_STATE_DATAPOINT_COUNT]; /**< The multi-state datapoints */
+  DatapointData_t uints[UINT_DATAPOINT_COUNT];              /**< The unsigned integer datapoints */
+} DatastoreSnapshot_t;
+
+/**
+ * @brief   The datapoint wait conditions.
+ */
+typedef enum
+{
+  DATASTORE_WAIT_EQUAL = 0,
+  DATASTORE_WAIT_NOT_EQUAL,
+  DATASTORE_WAIT_LESS,
+  DATASTORE_WAIT_LESS_EQUAL,
+  DATASTORE_WAIT_GREATER,
+  DATASTORE_WAIT_GREATER_EQUAL,
+  DATASTORE_WAIT_COND_COUNT,
+} DatastoreWaitCond_t;
+
+/**
+ * @brief   The datapoint read-modify-write operations.
+ */
+typedef enum
+{
+  DATASTORE_RMW_ADD = 0,                /**< value + operand */
+  DATASTORE_RMW_SUB,                    /**< value - operand */
+  DATASTORE_RMW_MIN,                    /**< The lowest of value and operand */
+  DATASTORE_RMW_MAX,                    /**< The highest of value and operand */
+  DATASTORE_RMW_SET_BITS,               /**< value | operand, integer types only */
+  DATASTORE_RMW_CLEAR_BITS,             /**< value & ~operand, integer types only */
+  DATASTORE_RMW_TOGGLE_BITS,            /**< value ^ operand, integer types only */
+  DATASTORE_RMW_CAS,                    /**< operand if value equals expected */
+  DATASTORE_RMW_OP_COUNT,
+} DatastoreRmwOp_t;
+
+/**
+ * @brief   The batch read descriptor.
+ */
+typedef struct
+{
+  DatapointType_t datapointType;        /**< The datapoint type */
+  uint32_t datapointId;                 /**< The first datapoint ID */
+  size_t valCount;                      /**< The count of value to read */
+  DatapointData_t *values;              /**< The output buffer */
+} DatastoreReadDesc_t;
+
+/**
+ * @brief   The bulk write descriptor.
+ */
+typedef struct
+{
+  DatapointType_t datapointType;        /**< The datapoint type */
+  uint32_t datapointId;                 /**< The first datapoint ID */
+  size_t valCount;                      /**< The count of value to write */
+  DatapointData_t *values;              /**< The values to write */
+} DatastoreWriteDesc_t;
+
+/**
+ * @brief   The changed datapoint query.
+ *
+ * @note    The cursor is the version of the last change returned, start
+ *          with 0 to get every datapoint changed since boot.
+ */
+typedef struct
+{
+  DatapointType_t datapointType;        /**< The datapoint type */
+  uint32_t cursor;                      /**< The caller cursor, updated with the query */
+  uint32_t *ids;                        /**< The changed datapoint IDs output buffer */
+  DatapointData_t *values;              /**< The changed datapoint values output buffer */
+  size_t maxCount;                      /**< The output buffers size */
+  size_t count;                         /**< The count of changed datapoints returned */
+} DatastoreChangeQuery_t;
+
+/**
+ * @brief   The asynchronous request completion callback.
+ *
+ * @note    The callback is called from the service thread, it must not block.
+ */
+typedef void (*DatastoreAsyncCb_t)(int status, void *userData);
+
+/**
+ * @brief   The asynchronous request completion record.
+ *
+ * @note    Every completion mean is optional, the ones that are set are used
+ *          in order: callback, work item and then signal.
+ */
+typedef struct
+{
+  struct k_poll_signal *signal;         /**< The signal raised with the request status */
+  struct k_work *work;                  /**< The work item submitted on completion */
+  DatastoreAsyncCb_t callback;          /**< The completion callback */
+  void *userData;                       /**< The completion callback user data */
+  int status;                           /**< The request status */
+} DatastoreAsync_t;
+
+/**
+ * @brief   The service ingress lanes.
+ */
+typedef enum
+{
+  DATASTORE_LANE_DEFAULT = 0,           /**< The lane set by the datapoint flags */
+  DATASTORE_LANE_URGENT,                /**< Always processed first */
+  DATASTORE_LANE_BULK,                  /**< Processed when the urgent lane is empty */
+  DATASTORE_LANE_COUNT,
+} DatastoreLane_t;
+
+/**
+ * @brief   The lane statistics.
+ */
+typedef struct
+{
+  uint32_t depth;                       /**< The lane capacity */
+  uint32_t used;                        /**< The messages waiting in the lane */
+  uint32_t maxUsed;                     /**< The highest count of messages seen waiting */
+  uint32_t putCount;                    /**< The messages queued */
+  uint32_t fullCount;                   /**< The messages refused because the lane was full */
+} DatastoreLaneStats_t;
+
+/**
+ * @brief   The backpressure policies applied to a write when its lane is full.
+ * @note    DATASTORE_POLICY_DROP_NEWEST plus the DATAPOINT_FLAG_POLICY_MASK value
+ *          of the datapoint flags gives the policy set by the flags.
+ */
+typedef enum
+{
+  DATASTORE_POLICY_DEFAULT = 0,         /**< The policy set by the datapoint flags */
+  DATASTORE_POLICY_DROP_NEWEST,         /**< Refuse the write */
+  DATASTORE_POLICY_DROP_OLDEST,         /**< Cancel the oldest write if it heads the lane, message queues only */
+  DATASTORE_POLICY_BLOCK,               /**< Wait for room until the timeout, threads only */
+  DATASTORE_POLICY_COALESCE,            /**< Merge with a pending write, message queue ingress only */
+  DATASTORE_POLICY_COUNT,
+} DatastorePolicy_t;
+
+/**
+ * @brief   The backpressure policy statistics.
+ */
+typedef struct
+{
+  uint32_t dropCount;                   /**< The requests dropped */
+  uint32_t waitCount;                   /**< The writes that waited for room */
+  uint32_t mergeCount;                  /**< The writes merged with a pending write */
+} DatastorePolicyStats_t;
+
+/**
+ * @brief   The write options.
+ * @note    A zeroed field keeps the setting of the datapoint flags.
+ */
+typedef struct
+{
+  DatastoreLane_t lane;                 /**< The ingress lane */
+  DatastorePolicy_t policy;             /**< The backpressure policy */
+  k_timeout_t timeout;                  /**< The wait timeout of the blocking policy */
+} DatastoreWriteOptions_t;
+
+/**
+ * @brief   A write staged in a transaction.
+ */
+typedef struct
+{
+  DatapointType_t datapointType;        /**< The datapoint type */
+  uint32_t datapointId;                 /**< The first datapoint ID */
+  size_t valCount;                      /**< The values count */
+  size_t valOffset;                     /**< The offset of the values in the transaction */
+} DatastoreTxnWrite_t;
+
+/**
+ * @brief   The write transaction.
+ */
+typedef struct
+{
+  DatastoreTxnWrite_t writes[DATASTORE_TXN_MAX_WRITES];   /**< The staged writes */
+  DatapointData_t values[DATASTORE_TXN_MAX_VALUES];       /**< The staged values */
+  size_t writeCount;                                      /**< The staged write count */
+  size_t valCount;                                        /**< The staged value count */
+  int status;                                             /**< The first staging error */
+} DatastoreTxn_t;
+
 /**
  * @brief   The binary subscription callback.
  */
@@ -188,13 +373,36 @@ typedef struct
   DatastoreUintSubCb_t callback;        /**< The subscription callback */
 } DatastoreUintSub_t;
 
+/**
+ * @brief   The datapoint ownership claim.
+ */
+typedef struct
+{
+  DatapointType_t datapointType;        /**< The datapoint type */
+  uint32_t datapointId;                 /**< The first owned datapoint ID */
+  size_t valCount;                      /**< The owned datapoint count */
+  k_tid_t thread;                       /**< The owner thread */
+} DatastoreOwner_t;
+
+/**
+ * @brief   A bulk apply session.
+ * @note    Zero initialized before its first use.
+ */
+typedef struct
+{
+  atomic_t isOpen;                      /**< The session open flag */
+} DatastoreBulkSession_t;
+
 /**
  * @brief   Initialize the datastore.
  *
+ * @note    In direct write mode the service thread is a work queue running
+ *          the notifications, the initial ones are submitted before returning.
+ *
  * @param[in]   maxSubs: The maximum subscriptions for each datatype.
- * @param[in]   maxBufferSize: The maximum buffer size.
+ * @param[in]   maxBufferSize: The maximum buffer size, in values, of a single write.
  * @param[in]   priority: The datastore thread priority
- * @param[out]  threadId: The service thread ID.
+ * @param[out]  threadId: The service thread ID, the work queue thread in direct write mode.
  *
  * @return  0 if successful, the error code otherwise.
  */
@@ -212,11 +420,167 @@ int datastoreInit(size_t maxSubs[DATAPOINT_TYPE_COUNT], size_t maxBufferSize, ui
  * @return  0 if successful, the error code otherwise.
  */
 int datastoreRead(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
-                  struct k_msgq *response, Datapoint_t values[]);
+                  struct k_msgq *response, DatapointData_t values[]);
+
+/**
+ * @brief   Read several datapoint ranges, of any type, in one request.
+ *
+ * @note    All the ranges are read in the same pass of the service thread so
+ *          the values are consistent with each other.
+ *
+ * @param[in,out] descs: The read descriptors.
+ * @param[in]     descCount: The count of read descriptors.
+ * @param[in]     response: The response queue.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadBatch(DatastoreReadDesc_t descs[], size_t descCount, struct k_msgq *response);
+
+/**
+ * @brief   Wait until a datapoint satisfies a condition.
+ *
+ * @note    The caller is parked on a semaphore and released by the service
+ *          thread on the write that satisfies the condition. The datapoint
+ *          current value is compared as <value> <cond> <compare value>, using
+ *          the datapoint type.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   cond: The condition.
+ * @param[in]   value: The value to compare with.
+ * @param[in]   timeout: The wait timeout.
+ *
+ * @return  0 if the condition is satisfied, the error code otherwise.
+ */
+int datastoreWaitFor(DatapointType_t datapointType, uint32_t datapointId, DatastoreWaitCond_t cond,
+                     DatapointData_t value, k_timeout_t timeout);
+
+/**
+ * @brief   Read the datapoints of a type changed since the query cursor.
+ *
+ * @note    The changes are returned from the oldest to the latest. If more
+ *          datapoints changed than the output buffers can hold, the cursor
+ *          is left on the last returned change and the next query returns
+ *          the rest.
+ *
+ * @param[in,out] query: The change query.
+ * @param[in]     response: The response queue.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadChanges(DatastoreChangeQuery_t *query, struct k_msgq *response);
+
+/**
+ * @brief   Take the latest snapshot of the whole datastore.
+ *
+ * @note    The snapshot is immutable and coherent across every datapoint type
+ *          until it is released. The service thread keeps writing into the
+ *          other bank but cannot publish a newer snapshot while one is held,
+ *          so release it as soon as possible. Snapshots are available only
+ *          when DATASTORE_SNAPSHOT_ENABLED is set.
+ *
+ * @return  The snapshot if successful, NULL otherwise.
+ */
+const DatastoreSnapshot_t *datastoreSnapshotAcquire(void);
+
+/**
+ * @brief   Release a snapshot.
+ *
+ * @param[in]   snapshot: The snapshot.
+ */
+void datastoreSnapshotRelease(const DatastoreSnapshot_t *snapshot);
+
+/**
+ * @brief   Read a datapoint without waiting for the service thread.
+ *
+ * @note    The output buffer and the completion record must stay valid until
+ *          the request completes.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ * @param[in]   async: The completion record.
+ *
+ * @return  0 if the request is queued, the error code otherwise.
+ */
+int datastoreReadAsync(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                       DatapointData_t values[], DatastoreAsync_t *async);
+
+/**
+ * @brief   Read several datapoint ranges without waiting for the service thread.
+ *
+ * @note    The descriptors, their output buffers and the completion record
+ *          must stay valid until the request completes.
+ *
+ * @param[in,out] descs: The read descriptors.
+ * @param[in]     descCount: The count of read descriptors.
+ * @param[in]     async: The completion record.
+ *
+ * @return  0 if the request is queued, the error code otherwise.
+ */
+int datastoreReadBatchAsync(DatastoreReadDesc_t descs[], size_t descCount, DatastoreAsync_t *async);
+
+/**
+ * @brief   Read a datapoint directly, without going through the service thread.
+ *
+ * @note    The read is lock-free and can be called from any thread. It fails
+ *          with -EAGAIN only if the datapoints kept changing during every copy
+ *          attempt.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadDirect(DatapointType_t datapointType, uint32_t datapointId, size_t valCount, DatapointData_t values[]);
+
+/**
+ * @brief   Read a datapoint and its last change timestamps directly.
+ *
+ * @note    The timestamps are the system uptime, in milliseconds, of the last
+ *          write that changed the value, 0 if it never changed since boot.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer (NULL, if not needed).
+ * @param[out]  timestamps: The last change timestamps output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadTimestamped(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                             DatapointData_t values[], uint32_t timestamps[]);
+
+/**
+ * @brief   Count the datapoints of a range that did not change for longer than a given age.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of datapoint to check.
+ * @param[in]   maxAge: The maximum age in milliseconds.
+ * @param[out]  staleCount: The count of datapoints older than the maximum age.
+ *
+ * @note    The timestamps are 32-bit uptime milliseconds, ages are computed modulo 2^32:
+ *          a datapoint unchanged for more than ~49.7 days can look fresh again. A datapoint
+ *          never changed since boot keeps the timestamp 0 and is aged from boot, like one
+ *          changed during the first millisecond.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreCountOlderThan(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                            uint32_t maxAge, size_t *staleCount);
 
 /**
  * @brief   Write a datapoint
  *
+ * @note    The values are copied before returning, small writes inside the
+ *          message and larger ones into a service pool buffer. The write is
+ *          validated against the datapoint limits before being queued, an
+ *          out of range value fails with -ERANGE.
+ *
  * @param[in]   datapointType: The datapoint type.
  * @param[in]   datapointId: The datapoint ID.
  * @param[in]   values: The values to write.
@@ -226,7 +590,296 @@ int datastoreRead(DatapointType_t datapointType, uint32_t datapointId, size_t va
  * @return  0 if successful, the error code.
  */
 int datastoreWrite(DatapointType_t datapointType, uint32_t datapointId,
-                   Datapoint_t values[], size_t valCount, struct k_msgq *response);
+                   DatapointData_t values[], size_t valCount, struct k_msgq *response);
+
+/**
+ * @brief   Write a datapoint with options.
+ *
+ * @note    Writes to a datapoint only keep their order within a lane. A
+ *          request dropped by the drop oldest policy completes with -ECANCELED.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values to write.
+ * @param[in]   valCount: The count of values to write.
+ * @param[in]   options: The write options (NULL, for the datapoint defaults).
+ * @param[in]   response: The response queue (NULL, if not needed).
+ *
+ * @return  0 if successful, the error code.
+ */
+int datastoreWriteWithOptions(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t values[],
+                              size_t valCount, const DatastoreWriteOptions_t *options, struct k_msgq *response);
+
+/**
+ * @brief   Write a datapoint without waiting for the service thread.
+ *
+ * @note    The values are copied before returning, the completion record
+ *          must stay valid until the request completes.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values to write.
+ * @param[in]   valCount: The count of values to write.
+ * @param[in]   async: The completion record.
+ *
+ * @return  0 if the request is queued, the error code otherwise.
+ */
+int datastoreWriteAsync(DatapointType_t datapointType, uint32_t datapointId,
+                        DatapointData_t values[], size_t valCount, DatastoreAsync_t *async);
+
+/**
+ * @brief   Get a write buffer from the datastore buffer pool.
+ *
+ * @note    The buffer holds up to the maxBufferSize values given to
+ *          datastoreInit(). It is handed back with
+ *          datastoreWriteBufferCommit() or datastoreWriteBufferRelease().
+ *
+ * @return  The buffer, NULL if the pool is empty or not initialized.
+ */
+DatapointData_t *datastoreWriteBufferGet(void);
+
+/**
+ * @brief   Write a datapoint from a write buffer, handing over its ownership.
+ *
+ * @note    The values are copied once, by the service thread, straight from
+ *          the buffer into the datapoints. The buffer then goes back to the
+ *          pool. The caller must not touch it after this call, even if it fails.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   buffer: The write buffer from datastoreWriteBufferGet().
+ * @param[in]   valCount: The count of values to write.
+ * @param[in]   response: The response queue (NULL, if not needed).
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreWriteBufferCommit(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t *buffer,
+                               size_t valCount, struct k_msgq *response);
+
+/**
+ * @brief   Return an unused write buffer to the datastore buffer pool.
+ *
+ * @param[in]   buffer: The write buffer from datastoreWriteBufferGet().
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreWriteBufferRelease(DatapointData_t *buffer);
+
+/**
+ * @brief   Claim a datapoint range for the calling thread.
+ *
+ * @note    The owner then writes the range with datastoreOwnerWrite(), in
+ *          its own context under the type lock. The service thread only does
+ *          the change bookkeeping and the notifications. Claims are not
+ *          available with the snapshot banks, nor for event datapoints.
+ *
+ * @param[out]  owner: The ownership claim.
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   valCount: The datapoint count.
+ *
+ * @return  0 if successful, -EBUSY if a datapoint is already owned, the error code otherwise.
+ */
+int datastoreOwnerClaim(DatastoreOwner_t *owner, DatapointType_t datapointType, uint32_t datapointId,
+                        size_t valCount);
+
+/**
+ * @brief   Release an ownership claim.
+ *
+ * @param[in]   owner: The ownership claim.
+ */
+void datastoreOwnerRelease(DatastoreOwner_t *owner);
+
+/**
+ * @brief   Write owned datapoints from the owner thread.
+ *
+ * @note    The values are stored before the type write counter is bumped,
+ *          a direct reader never sees them half written. A write to an owned
+ *          datapoint through any other write function fails with -EPERM. In
+ *          debug builds a write from another thread fails with -EPERM too.
+ *
+ * @param[in]   owner: The ownership claim.
+ * @param[in]   datapointId: The datapoint ID, within the claim.
+ * @param[in]   values: The values to write.
+ * @param[in]   valCount: The count of values to write.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreOwnerWrite(DatastoreOwner_t *owner, uint32_t datapointId, DatapointData_t values[], size_t valCount);
+
+/**
+ * @brief   Write a datapoint from an ISR.
+ *
+ * @note    The values are copied into a preallocated lock-free ring drained
+ *          by the service thread at the start of each loop iteration. No lock
+ *          is taken and nothing waits.
+ *
+ * @note    Worst case on a single core: 1 + N slot reservation compare-and-swap
+ *          attempts, N being the count of nested interrupt levels also writing,
+ *          one copy of a ring record (4 bytes plus DATASTORE_ISR_MAX_VALUES
+ *          values) and one sequence store. That is about 70 cycles plus 25
+ *          cycles per nested level on a Cortex-M4 (instruction count estimate),
+ *          plus one k_sem_give() if the service thread sleeps, or one
+ *          k_work_submit() in direct write mode. The bound assumes a single
+ *          core: on SMP targets another core can win every compare-and-swap,
+ *          the retries are then not bounded.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values to write.
+ * @param[in]   valCount: The count of values to write, up to DATASTORE_ISR_MAX_VALUES.
+ *
+ * @return  0 if successful, -ENOMSG if the ring is full, the error code otherwise.
+ */
+int datastoreWriteFromIsr(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t values[], size_t valCount);
+
+/**
+ * @brief   Get the count of events dropped because a button event ring was full.
+ *
+ * @note    A button datapoint flagged with DATAPOINT_FLAG_EVENT_MASK queues
+ *          every written value, changed or not, in a ring of
+ *          DATASTORE_EVENT_RING_SIZE events. Its subscribers get each event
+ *          in order. A full ring drops its oldest event.
+ *
+ * @param[in]   datapointId: The button datapoint ID.
+ *
+ * @return  The overflow count, 0 for an unknown datapoint.
+ */
+uint32_t datastoreButtonEventOverflowCount(uint32_t datapointId);
+
+/**
+ * @brief   Get the count of ISR writes dropped because the ring was full.
+ *
+ * @return  The overflow count.
+ */
+uint32_t datastoreIsrOverflowCount(void);
+
+/**
+ * @brief   Get the statistics of a backpressure policy.
+ *
+ * @param[in]   policy: The policy.
+ * @param[out]  stats: The policy statistics.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreGetPolicyStats(DatastorePolicy_t policy, DatastorePolicyStats_t *stats);
+
+/**
+ * @brief   Get the statistics of an ingress lane.
+ *
+ * @param[in]   lane: The lane.
+ * @param[out]  stats: The lane statistics.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreGetLaneStats(DatastoreLane_t lane, DatastoreLaneStats_t *stats);
+
+/**
+ * @brief   Begin a write transaction.
+ *
+ * @param[out]  txn: The transaction.
+ */
+void datastoreTxnBegin(DatastoreTxn_t *txn);
+
+/**
+ * @brief   Stage a write in a transaction.
+ *
+ * @note    The values are copied into the transaction. A staging error is
+ *          kept and returned again by the commit.
+ *
+ * @param[in,out] txn: The transaction.
+ * @param[in]     datapointType: The datapoint type.
+ * @param[in]     datapointId: The datapoint ID.
+ * @param[in]     values: The values to write.
+ * @param[in]     valCount: The count of values to write.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreTxnStage(DatastoreTxn_t *txn, DatapointType_t datapointType, uint32_t datapointId,
+                      DatapointData_t values[], size_t valCount);
+
+/**
+ * @brief   Commit a write transaction.
+ *
+ * @note    The staged writes are applied together by the service thread and
+ *          the subscribers are notified once, after all of them. Nothing is
+ *          written if any staged write is invalid.
+ *
+ * @note    The transaction is read in place, once queued the call waits for
+ *          the response without a timeout.
+ *
+ * @param[in]   txn: The transaction.
+ * @param[in]   response: The response queue.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreTxnCommit(DatastoreTxn_t *txn, struct k_msgq *response);
+
+/**
+ * @brief   Start a bulk apply session, the notifications are suspended.
+ *
+ * @note    Every write until datastoreBulkEnd() only marks its datapoints
+ *          dirty. Sessions nest, the notifications resume with the last end.
+ *          Once queued, the request is waited for without timeout.
+ *
+ * @param[in,out] session: The session.
+ * @param[in]   response: The response queue.
+ *
+ * @return  0 if successful, -EALREADY if the session is already started, the error code otherwise.
+ */
+int datastoreBulkBegin(DatastoreBulkSession_t *session, struct k_msgq *response);
+
+/**
+ * @brief   Apply a list of writes.
+ *
+ * @note    Every write is validated before being queued. The service thread
+ *          applies them in order and notifies the subscribers once, after
+ *          all of them, unless a bulk apply session is in progress. A write
+ *          failing in the service thread does not undo the previous ones.
+ *          The descriptors and their values are read in place: the store owns
+ *          them until the response arrives, which is waited for without timeout.
+ *
+ * @param[in]   descs: The write descriptors.
+ * @param[in]   descCount: The write descriptor count.
+ * @param[in]   response: The response queue.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreBulkApply(DatastoreWriteDesc_t descs[], size_t descCount, struct k_msgq *response);
+
+/**
+ * @brief   End a bulk apply session.
+ *
+ * @note    Ending the outermost session makes a single notification pass,
+ *          each affected subscriber is called once. Once queued, the request
+ *          is waited for without timeout.
+ *
+ * @param[in,out] session: The session.
+ * @param[in]   response: The response queue.
+ *
+ * @return  0 if successful, -EALREADY if the session is not started, the error code otherwise.
+ */
+int datastoreBulkEnd(DatastoreBulkSession_t *session, struct k_msgq *response);
+
+/**
+ * @brief   Read, modify and write a datapoint atomically in the service thread.
+ *
+ * @note    Integer values wrap around on overflow. The old value is reported
+ *          even when a compare-and-swap does not match.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   op: The operation.
+ * @param[in]   operand: The operand.
+ * @param[in]   expected: The expected value of a compare-and-swap (ignored otherwise).
+ * @param[out]  oldValue: The value before the operation (NULL, if not needed).
+ * @param[in]   response: The response queue (NULL, if not needed, only without old value).
+ *
+ * @return  0 if successful, -EAGAIN if a compare-and-swap did not match, the error code otherwise.
+ */
+int datastoreModify(DatapointType_t datapointType, uint32_t datapointId, DatastoreRmwOp_t op,
+                    DatapointData_t operand, DatapointData_t expected, DatapointData_t *oldValue,
+                    struct k_msgq *response);
 
 /**
  * @brief   Subscribe to binary datapoint.
@@ -267,6 +920,17 @@ int datastoreUnpauseSubBinary(DatastoreBinarySubCb_t subCallback);
  */
 int datastoreReadBinary(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[]);
 
+/**
+ * @brief   Read a binary datapoint directly.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadBinaryDirect(uint32_t datapointId, size_t valCount, uint32_t values[]);
+
 /**
  * @brief   Write a binary datapoint
  *
@@ -318,6 +982,17 @@ int datastoreUnpauseSubButton(DatastoreButtonSubCb_t subCallback);
  */
 int datastoreReadButton(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[]);
 
+/**
+ * @brief   Read a button datapoint directly.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadButtonDirect(uint32_t datapointId, size_t valCount, uint32_t values[]);
+
 /**
  * @brief   Write a button datapoint
  *
@@ -369,6 +1044,17 @@ int datastoreUnpauseSubFloat(DatastoreFloatSubCb_t subCallback);
  */
 int datastoreReadFloat(uint32_t datapointId, size_t valCount, struct k_msgq *response, float values[]);
 
+/**
+ * @brief   Read a float datapoint directly.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadFloatDirect(uint32_t datapointId, size_t valCount, float values[]);
+
 /**
  * @brief   Write a float datapoint
  *
@@ -420,6 +1106,17 @@ int datastoreUnpauseSubInt(DatastoreIntSubCb_t subCallback);
  */
 int datastoreReadInt(uint32_t datapointId, size_t valCount, struct k_msgq *response, int32_t values[]);
 
+/**
+ * @brief   Read an integer datapoint directly.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadIntDirect(uint32_t datapointId, size_t valCount, int32_t values[]);
+
 /**
  * @brief   Write a integer datapoint
  *
@@ -471,6 +1168,17 @@ int datastoreUnpauseSubMultiState(DatastoreMultiStateSubCb_t subCallback);
  */
 int datastoreReadMultiState(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[]);
 
+/**
+ * @brief   Read a multi-state datapoint directly.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadMultiStateDirect(uint32_t datapointId, size_t valCount, uint32_t values[]);
+
 /**
  * @brief   Write a multi-state datapoint
  *
@@ -522,6 +1230,17 @@ int datastoreUnpauseSubUint(DatastoreUintSubCb_t subCallback);
  */
 int datastoreReadUint(uint32_t datapointId, size_t valCount, struct k_msgq *response, uint32_t values[]);
 
+/**
+ * @brief   Read an unsigned integer datapoint directly.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of value to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreReadUintDirect(uint32_t datapointId, size_t valCount, uint32_t values[]);
+
 /**
  * @brief   Write an unsigned integer datapoint
  *
@@ -0,0 +1,227 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreAccessor.h
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Typed Accessors
+ *
+ *            Per-datapoint typed getters and setters generated from the
+ *            X-macros in datastoreMeta.h. The datapoint type, ID and bounds
+ *            are fixed at compile time and the setters take a wrapper of the
+ *            datapoint type, so using the wrong type or an unknown datapoint
+ *            fails to build.
+ *
+ *            The getters read the primary bank, not the per-CPU read replicas:
+ *            use datastoreReadDirect() to read from the replica of the current
+ *            CPU.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#ifndef DATASTORE_SRV_ACCESSOR
+#define DATASTORE_SRV_ACCESSOR
+
+#include <zephyr/kernel.h>
+
+#include "datastore.h"
+
+#if DATASTORE_SNAPSHOT_ENABLED
+/**
+ * @brief   The working datapoint bank.
+ */
+extern DatastoreSnapshot_t *datastoreWorkingBank;
+
+/**
+ * @brief   The bank the getters read from.
+ * @note    The bank pointer is reloaded on every read, the banks are swapped
+ *          by the service thread.
+ */
+#define DATASTORE_ACCESSOR_BANK                                   (**(DatastoreSnapshot_t *volatile *)&datastoreWorkingBank)
+#else
+/**
+ * @brief   The datapoint banks.
+ */
+extern DatastoreSnapshot_t datastoreBanks[DATASTORE_BANK_COUNT];
+
+/**
+ * @brief   The bank the getters read from.
+ */
+#define DATASTORE_ACCESSOR_BANK                                   (datastoreBanks[0])
+#endif
+
+/**
+ * @brief   Binary datapoint setter value.
+ */
+typedef struct
+{
+  bool val;                             /**< The value */
+} DatastoreBinaryValue_t;
+
+/**
+ * @brief   Button datapoint setter value.
+ */
+typedef struct
+{
+  uint32_t val;                         /**< The value */
+} DatastoreButtonValue_t;
+
+/**
+ * @brief   Float datapoint setter value.
+ */
+typedef struct
+{
+  float val;                            /**< The value */
+} DatastoreFloatValue_t;
+
+/**
+ * @brief   Signed integer datapoint setter value.
+ */
+typedef struct
+{
+  int32_t val;                          /**< The value */
+} DatastoreIntValue_t;
+
+/**
+ * @brief   Multi-state datapoint setter value.
+ */
+typedef struct
+{
+  uint32_t val;                         /**< The value */
+} DatastoreMultiStateValue_t;
+
+/**
+ * @brief   Unsigned integer datapoint setter value.
+ */
+typedef struct
+{
+  uint32_t val;                         /**< The value */
+} DatastoreUintValue_t;
+
+/**
+ * @brief   Read a datapoint value straight from the accessor bank.
+ *
+ * @note    A datapoint value is a single aligned word, the load cannot tear.
+ */
+#define DATASTORE_ACCESSOR_LOAD(typeArray, datapointId) \
+  (((volatile DatapointData_t *)&DATASTORE_ACCESSOR_BANK.typeArray[(datapointId)]))
+
+/**
+ * @brief   Binary datapoint accessors.
+ * @note    dsGet_<name>() returns the current value, dsSet_<name>(value, response)
+ *          writes it through the service thread, waiting for the response if any.
+ *          The value is given as a DatastoreBinaryValue_t.
+ */
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) \
+  static inline bool dsGet_##name(void) \
+  { \
+    return DATASTORE_ACCESSOR_LOAD(binaries, name)->uintVal != 0; \
+  } \
+  static inline int dsSet_##name(DatastoreBinaryValue_t value, struct k_msgq *response) \
+  { \
+    DatapointData_t data = {.uintVal = value.val ? 1 : 0}; \
+    return datastoreWrite(DATAPOINT_BINARY, name, &data, 1, response); \
+  }
+DATASTORE_BINARY_DATAPOINTS
+#undef X
+
+/**
+ * @brief   Button datapoint accessors.
+ * @note    dsGet_<name>() returns the current value, dsSet_<name>(value, response)
+ *          writes it through the service thread, waiting for the response if any.
+ *          The value is given as a DatastoreButtonValue_t.
+ */
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) \
+  static inline uint32_t dsGet_##name(void) \
+  { \
+    return DATASTORE_ACCESSOR_LOAD(buttons, name)->uintVal; \
+  } \
+  static inline int dsSet_##name(DatastoreButtonValue_t value, struct k_msgq *response) \
+  { \
+    DatapointData_t data = {.uintVal = value.val}; \
+    return datastoreWrite(DATAPOINT_BUTTON, name, &data, 1, response); \
+  }
+DATASTORE_BUTTON_DATAPOINTS
+#undef X
+
+/**
+ * @brief   Float datapoint accessors.
+ * @note    dsGet_<name>() returns the current value, dsSet_<name>(value, response)
+ *          writes it through the service thread, waiting for the response if any.
+ *          The value is given as a DatastoreFloatValue_t.
+ */
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) \
+  static inline float dsGet_##name(void) \
+  { \
+    return DATASTORE_ACCESSOR_LOAD(floats, name)->floatVal; \
+  } \
+  static inline int dsSet_##name(DatastoreFloatValue_t value, struct k_msgq *response) \
+  { \
+    DatapointData_t data = {.floatVal = value.val}; \
+    return datastoreWrite(DATAPOINT_FLOAT, name, &data, 1, response); \
+  }
+DATASTORE_FLOAT_DATAPOINTS
+#undef X
+
+/**
+ * @brief   Signed integer datapoint accessors.
+ * @note    dsGet_<name>() returns the current value, dsSet_<name>(value, response)
+ *          writes it through the service thread, waiting for the response if any.
+ *          The value is given as a DatastoreIntValue_t.
+ */
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) \
+  static inline int32_t dsGet_##name(void) \
+  { \
+    return DATASTORE_ACCESSOR_LOAD(ints, name)->intVal; \
+  } \
+  static inline int dsSet_##name(DatastoreIntValue_t value, struct k_msgq *response) \
+  { \
+    DatapointData_t data = {.intVal = value.val}; \
+    return datastoreWrite(DATAPOINT_INT, name, &data, 1, response); \
+  }
+DATASTORE_INT_DATAPOINTS
+#undef X
+
+/**
+ * @brief   Multi-state datapoint accessors.
+ * @note    dsGet_<name>() returns the current value, dsSet_<name>(value, response)
+ *          writes it through the service thread, waiting for the response if any.
+ *          The value is given as a DatastoreMultiStateValue_t.
+ */
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) \
+  static inline uint32_t dsGet_##name(void) \
+  { \
+    return DATASTORE_ACCESSOR_LOAD(multiStates, name)->uintVal; \
+  } \
+  static inline int dsSet_##name(DatastoreMultiStateValue_t value, struct k_msgq *response) \
+  { \
+    DatapointData_t data = {.uintVal = value.val}; \
+    return datastoreWrite(DATAPOINT_MULTI_STATE, name, &data, 1, response); \
+  }
+DATASTORE_MULTI_STATE_DATAPOINTS
+#undef X
+
+/**
+ * @brief   Unsigned integer datapoint accessors.
+ * @note    dsGet_<name>() returns the current value, dsSet_<name>(value, response)
+ *          writes it through the service thread, waiting for the response if any.
+ *          The value is given as a DatastoreUintValue_t.
+ */
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) \
+  static inline uint32_t dsGet_##name(void) \
+  { \
+    return DATASTORE_ACCESSOR_LOAD(uints, name)->uintVal; \
+  } \
+  static inline int dsSet_##name(DatastoreUintValue_t value, struct k_msgq *response) \
+  { \
+    DatapointData_t data = {.uintVal = value.val}; \
+    return datastoreWrite(DATAPOINT_UINT, name, &data, 1, response); \
+  }
+DATASTORE_UINT_DATAPOINTS
+#undef X
+
+#endif    /* DATASTORE_SRV_ACCESSOR */
+
+/** @} */
@@ -33,11 +33,11 @@ static int allocateBuffers(DatastoreBufferPool_t*pool)
 
   for(size_t i = 0; i < pool->poolSize && err == 0; i++)
   {
-    pool->buffers[i] = k_malloc(pool->bufferSize);
+    pool->buffers[i] = k_malloc(pool->bufferSize * sizeof(DatapointData_t));
     if(!pool->buffers[i])
     {
       err = -ENOSPC;
-      LOG_ERR("ERROR %d: unable to allocate buffer %d", err, i);
+      LOG_ERR("ERROR %d: unable to allocate buffer %zu", err, i);
     }
   }
 
@@ -72,7 +72,8 @@ DatastoreBufferPool_t *datastoreBufPoolInit(size_t bufferSize, size_t poolSize)
   }
 
   pool->bufferSize = bufferSize;
-  pool->bufferInPool = bufferSize;
+  pool->bufferInPool = poolSize;
+  pool->lock = (struct k_spinlock){};
   pool->poolSize = poolSize;
 
   pool->buffers = k_malloc(pool->poolSize * sizeof(DatapointData_t*));
@@ -92,6 +93,7 @@ DatastoreBufferPool_t *datastoreBufPoolInit(size_t bufferSize, size_t poolSize)
 
 DatapointData_t *datastoreBufPoolGet(DatastoreBufferPool_t *pool)
 {
+  k_spinlock_key_t key;
   DatapointData_t *buffer = NULL;
 
   if(!pool)
@@ -100,31 +102,46 @@ DatapointData_t *datastoreBufPoolGet(DatastoreBufferPool_t *pool)
     return buffer;
   }
 
-  if(pool->bufferInPool == 0)
+  key = k_spin_lock(&pool->lock);
+
+  if(pool->bufferInPool > 0)
   {
-    LOG_ERR("ERROR %d: no more buffer in the pool", -ENOSPC);
-    return buffer;
+    buffer = pool->buffers[pool->bufferInPool - 1];
+    pool->buffers[pool->bufferInPool - 1] = NULL;
+    pool->bufferInPool--;
   }
 
-  buffer = pool->buffers[pool->bufferInPool - 1];
-  pool->buffers[pool->bufferInPool - 1] = NULL;
-  pool->bufferInPool--;
+  k_spin_unlock(&pool->lock, key);
+
+  if(!buffer)
+    LOG_ERR("ERROR %d: no more buffer in the pool", -ENOSPC);
 
   return buffer;
 }
 
 int datastoreBufPoolReturn(DatastoreBufferPool_t *pool, DatapointData_t *buffer)
 {
-  if(!pool)
+  int err = 0;
+  k_spinlock_key_t key;
+
+  if(!pool || !buffer)
     return -EINVAL;
 
-  if(pool->bufferInPool >= pool->poolSize && pool->buffers[pool->bufferInPool])
-    return -ENOSPC;
+  key = k_spin_lock(&pool->lock);
 
-  pool->buffers[pool->bufferInPool] = buffer;
-  pool->bufferInPool++;
+  if(pool->bufferInPool < pool->poolSize)
+  {
+    pool->buffers[pool->bufferInPool] = buffer;
+    pool->bufferInPool++;
+  }
+  else
+  {
+    err = -ENOSPC;
+  }
+
+  k_spin_unlock(&pool->lock, key);
 
-  return 0;
+  return err;
 }
 
 /** @} */
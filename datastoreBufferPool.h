@@ -26,12 +26,13 @@ typedef struct
   size_t bufferSize;
   size_t bufferInPool;
   DatapointData_t **buffers;
+  struct k_spinlock lock;
 } DatastoreBufferPool_t;
 
 /**
  * @brief   Initialize the datastore buffer pool.
  *
- * @param bufferSize    The size of the buffers.
+ * @param bufferSize    The size of the buffers, in datapoint values.
  * @param poolSize      The pool size, the number of buffer in the pool.
  *
  * @return  The handle to the created buffer pool if successful, NULL otherwise.
@@ -41,6 +42,8 @@ DatastoreBufferPool_t *datastoreBufPoolInit(size_t bufferSize, size_t poolSize);
 /**
  * @brief   Get a buffer from the pool.
  *
+ * @note    Callable from any thread or ISR.
+ *
  * @param pool          The buffer pool.
  *
  * @return  The free buffer if successful, NULL otherwise.
@@ -50,6 +53,8 @@ DatapointData_t *datastoreBufPoolGet(DatastoreBufferPool_t *pool);
 /**
  * @brief   Return a buffer to the pool.
  *
+ * @note    Callable from any thread or ISR.
+ *
  * @param pool          The buffer pool.
  * @param buffer        The buffer.
  *
@@ -29,65 +29,73 @@
 /**
  * @brief   The list of datapoint type names.
  */
-static char *typeNames[DATAPOINT_TYPE_COUNT] = {"float", "uint", "int", "multi-state", "button"};
+static char *typeNames[DATAPOINT_TYPE_COUNT] = {"binary", "button", "float", "int", "multi-state", "uint"};
+
+/**
+ * @brief   The list of binary datapoint names.
+ */
+static char *binaryNames[BINARY_DATAPOINT_COUNT] = {
+#define X(name, flags, defaultVal, band, minVal, maxVal) STRINGIFY(name),
+  DATASTORE_BINARY_DATAPOINTS
+#undef X
+};
 
 /**
  * @brief   The list of float datapoint names.
  */
 static char *floatNames[FLOAT_DATAPOINT_COUNT] = {
-#define X(name, flags, defaultVal) STRINGIFY(name),
+#define X(name, flags, defaultVal, band, minVal, maxVal) STRINGIFY(name),
   DATASTORE_FLOAT_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
  * @brief   The list of unsigned integer datapoint names.
  */
 static char *uintNames[UINT_DATAPOINT_COUNT] = {
-#define X(name, flags, defaultVal) STRINGIFY(name),
+#define X(name, flags, defaultVal, band, minVal, maxVal) STRINGIFY(name),
   DATASTORE_UINT_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
  * @brief   The list of signed integer datapoint names.
  */
 static char *intNames[INT_DATAPOINT_COUNT] = {
-#define X(name, flags, defaultVal) STRINGIFY(name),
+#define X(name, flags, defaultVal, band, minVal, maxVal) STRINGIFY(name),
   DATASTORE_INT_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
  * @brief   The list of multi-state datapoint names.
  */
 static char *multiStateNames[MULTI_STATE_DATAPOINT_COUNT] = {
-#define X(name, flags, defaultVal) STRINGIFY(name),
+#define X(name, flags, defaultVal, band, minVal, maxVal) STRINGIFY(name),
   DATASTORE_MULTI_STATE_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
  * @brief   The list of button datapoint names.
  */
 static char *buttonNames[BUTTON_DATAPOINT_COUNT] = {
-#define X(name, flags, defaultVal) STRINGIFY(name),
+#define X(name, flags, defaultVal, band, minVal, maxVal) STRINGIFY(name),
   DATASTORE_BUTTON_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
  * @brief   The list of all datapoint name by their type.
  */
-static char **datapointNames[DATAPOINT_TYPE_COUNT] = {floatNames, uintNames, intNames, multiStateNames, buttonNames};
+static char **datapointNames[DATAPOINT_TYPE_COUNT] = {binaryNames, buttonNames, floatNames, intNames, multiStateNames,
+                                                      uintNames};
 
 /**
  * @brief   The list of datapoint count by their type.
  */
-static size_t datapointCounts[DATAPOINT_TYPE_COUNT] = {FLOAT_DATAPOINT_COUNT, UINT_DATAPOINT_COUNT, INT_DATAPOINT_COUNT,
-                                                       MULTI_STATE_DATAPOINT_COUNT, BUTTON_DATAPOINT_COUNT};
-
-static char *valFormats[DATAPOINT_TYPE_COUNT] = {"%f", "%u", "%d", "%u", "%u"}
+static size_t datapointCounts[DATAPOINT_TYPE_COUNT] = {BINARY_DATAPOINT_COUNT, BUTTON_DATAPOINT_COUNT, FLOAT_DATAPOINT_COUNT,
+                                                       INT_DATAPOINT_COUNT, MULTI_STATE_DATAPOINT_COUNT, UINT_DATAPOINT_COUNT};
 
 /**
  * @brief   Datastore command response queue.
@@ -106,23 +114,12 @@ K_MSGQ_DEFINE(datastoreCmdResQueue, sizeof(int), DATASTORE_MSG_COUNT, 4);
  */
 static int getStringIndex(char *str, char **strList, size_t listSize, uint32_t *index)
 {
-  char *listedStr;
-  bool indexFound = false;
-
-  *index = 0;
-  listedStr = strList[*index];
-
-  while(!indexfound && *index < listSize)
+  for(*index = 0; *index < listSize; ++(*index))
   {
-    if(strcmp(str, listedStr) != 0)
-      indexFound = true;
-
-    ++(*index);
+    if(strcmp(str, strList[*index]) == 0)
+      return 0;
   }
 
-  if(indexFound)
-    return 0;
-
   return -ESRCH;
 }
 
@@ -135,8 +132,8 @@ static void toUpper(char *str)
 {
   size_t strLength = strlen(str);
 
-  for(size_t i = 0; i < strlen; ++i)
-    str[i] = toupper(str[i]);
+  for(size_t i = 0; i < strLength; ++i)
+    str[i] = toupper((unsigned char)str[i]);
 }
 
 /**
@@ -154,7 +151,7 @@ static int execListTypes(const struct shell *shell, size_t argc, char **argv)
   ARG_UNUSED(argv);
 
   for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; ++i)
-    shell_info(shell, typeNames[i]);
+    shell_info(shell, "%s", typeNames[i]);
 
   return 0;
 }
@@ -170,31 +167,55 @@ static int execListTypes(const struct shell *shell, size_t argc, char **argv)
  */
 static int convertValueFromString(DatapointType_t datapointType, char *str, DatapointData_t *value)
 {
-  int err;
   char *endPtr;
 
   switch(datapointType)
   {
     case DATAPOINT_FLOAT:
-      value->floatVal = strtof(str, endPtr);
+      value->floatVal = strtof(str, &endPtr);
     break;
     case DATAPOINT_INT:
-      value->intVal = strtol(str, endPtr);
+      value->intVal = strtol(str, &endPtr, 0);
     break;
-    case DATAPOINT_UINT:
-    case DATAPOINT_MULTI_STATE:
+    case DATAPOINT_BINARY:
     case DATAPOINT_BUTTON:
-      value->uintVal = strtoul(str, endPtr);
+    case DATAPOINT_MULTI_STATE:
+    case DATAPOINT_UINT:
+      value->uintVal = strtoul(str, &endPtr, 0);
     break;
     default:
       return -ENOTSUP;
     break;
   }
 
-  if(endPtr != str + strlen(str))
-    err = value->intVal;
+  if(endPtr == str || *endPtr != '\0')
+    return -EINVAL;
+
+  return 0;
+}
 
-  return err;
+/**
+ * @brief   Convert a value to string.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   value: The value to convert.
+ * @param[out]  str: The output string.
+ * @param[in]   strSize: The output string size.
+ */
+static void convertValueToString(DatapointType_t datapointType, DatapointData_t value, char *str, size_t strSize)
+{
+  switch(datapointType)
+  {
+    case DATAPOINT_FLOAT:
+      snprintf(str, strSize, "%f", (double)value.floatVal);
+    break;
+    case DATAPOINT_INT:
+      snprintf(str, strSize, "%d", value.intVal);
+    break;
+    default:
+      snprintf(str, strSize, "%u", value.uintVal);
+    break;
+  }
 }
 
 /**
@@ -225,7 +246,7 @@ static int execListDatapoint(const struct shell *shell, size_t argc, char **argv
   datapointCount = datapointCounts[type];
 
   for(uint32_t i = 0; i < datapointCount; ++i)
-    shell_info(shell, datapointNames[type][i]);
+    shell_info(shell, "%s", datapointNames[type][i]);
 
   return 0;
 }
@@ -242,10 +263,9 @@ static int execListDatapoint(const struct shell *shell, size_t argc, char **argv
 static int execReadDatapoint(const struct shell *shell, size_t argc, char **argv)
 {
   int err;
-  size_t datapointCount;
   DatapointType_t type;
   uint32_t datapointId;
-  Datapoint_t value;
+  DatapointData_t value;
   char valueStr[DATASTORE_CMD_VALUE_STR_LENGTH + 1] = {'\0'};
 
   ARG_UNUSED(argc);
@@ -268,14 +288,14 @@ static int execReadDatapoint(const struct shell *shell, size_t argc, char **argv
     return err;
   }
 
-  err = dataStoreRead(type, datapointId, 1, &datastoreCmdResQueue, &value);
+  err = datastoreRead(type, datapointId, 1, &datastoreCmdResQueue, &value);
   if(err < 0)
   {
     shell_error(shell, "FAIL: error %d reading datapoint %s of type %s", err, argv[2], argv[1]);
     return err;
   }
 
-  sprint(valueStr, valFormats[type], value);
+  convertValueToString(type, value, valueStr, sizeof(valueStr));
 
   shell_info(shell, "SUCCESS: %s = %s", argv[2], valueStr);
 
@@ -294,7 +314,6 @@ static int execReadDatapoint(const struct shell *shell, size_t argc, char **argv
 static int execWriteDatapoint(const struct shell *shell, size_t argc, char **argv)
 {
   int err;
-  size_t datapointCount;
   DatapointType_t type;
   uint32_t datapointId;
   DatapointData_t value;
@@ -322,12 +341,12 @@ static int execWriteDatapoint(const struct shell *shell, size_t argc, char **arg
   err = convertValueFromString(type, argv[3], &value);
   if(err < 0)
   {
-    shell_erro(shell, "FAIL: error %d converting the datapoint %s value of %s", err, argv[2], argv[3]);
+    shell_error(shell, "FAIL: error %d converting the datapoint %s value of %s", err, argv[2], argv[3]);
     shell_help(shell);
     return err;
   }
 
-  err = dataStoreWrite(type, datapointId, 1, &datastoreCmdResQueue, &value);
+  err = datastoreWrite(type, datapointId, &value, 1, &datastoreCmdResQueue);
   if(err < 0)
   {
     shell_error(shell, "FAIL: error %d writing datapoint %s of type %s", err, argv[2], argv[1]);
@@ -340,14 +359,14 @@ static int execWriteDatapoint(const struct shell *shell, size_t argc, char **arg
 }
 
 SHELL_STATIC_SUBCMD_SET_CREATE(datastore_sub,
-	SHELL_CMD(ls_types, NULL, "List the datapoint types.\n\tUsage: datastore ls_types", execListTypes),
-  SHELL_CMD_ARG(ls, NULL, "List the datapoints of a type.\n\tUsage: datastore ls <float|uint|int|multi-state|button>",
-                execListDatapoint, 2, 0);
-	SHELL_CMD_ARG(read, NULL, "Read a datapoint.\n\tUsage: datastore read <float|uint|int|multi-state|button> <datapoint_name>",
-                execReadDatapoint, 2, 0),
-	SHELL_CMD_ARG(write, NULL, "Write a datapoint.\n\tUsage: datastore read <float|uint|int|multi-state|button> <datapoint_name>",
-                execWriteDatapoint, 3, 0),
-	SHELL_SUBCMD_SET_END);
-SHELL_CMD_REGISTER(datastore, &datastore_sub, APP_CMD_USAGE,	NULL);
+  SHELL_CMD(ls_types, NULL, "List the datapoint types.\n\tUsage: datastore ls_types", execListTypes),
+  SHELL_CMD_ARG(ls, NULL, "List the datapoints of a type.\n\tUsage: datastore ls <binary|button|float|int|multi-state|uint>",
+                execListDatapoint, 2, 0),
+  SHELL_CMD_ARG(read, NULL, "Read a datapoint.\n\tUsage: datastore read <binary|button|float|int|multi-state|uint> <datapoint_name>",
+                execReadDatapoint, 3, 0),
+  SHELL_CMD_ARG(write, NULL, "Write a datapoint.\n\tUsage: datastore write <binary|button|float|int|multi-state|uint> <datapoint_name> <value>",
+                execWriteDatapoint, 4, 0),
+  SHELL_SUBCMD_SET_END);
+SHELL_CMD_REGISTER(datastore, &datastore_sub, "Datastore commands", NULL);
 
 /** @} */
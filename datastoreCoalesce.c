@@ -0,0 +1,242 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreCoalesce.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Write Coalescing Implementation
+ *
+ *            Implementation of the pending write coalescing.
+ *
+ * @ingroup   datastore
+ * @{
+ */
+
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+#include "datastoreCoalesce.h"
+
+/* Setting module logging */
+LOG_MODULE_DECLARE(DATASTORE_LOGGER_NAME);
+
+/**
+ * @brief   The pending write slot states.
+ */
+typedef enum
+{
+  COALESCE_SLOT_FREE = 0,                                 /**< The slot is free */
+  COALESCE_SLOT_RESERVED,                                 /**< The slot is not queued yet */
+  COALESCE_SLOT_PUBLISHED,                                /**< The slot is queued and open to coalescing */
+  COALESCE_SLOT_TAKEN,                                    /**< The slot was taken before being published */
+} DatastoreCoalesceState_t;
+
+/**
+ * @brief   The pending write slot.
+ */
+typedef struct
+{
+  DatastoreCoalesceState_t state;                         /**< The slot state */
+  bool isSealed;                                          /**< The no more coalescing flag */
+  DatapointType_t datapointType;                          /**< The datapoint type */
+  uint32_t datapointId;                                   /**< The datapoint ID */
+  size_t valCount;                                        /**< The count of values */
+  DatapointData_t values[DATASTORE_COALESCE_MAX_VALUES];  /**< The latest values */
+} DatastoreCoalesceSlot_t;
+
+/**
+ * @brief   The pending write slots.
+ */
+static DatastoreCoalesceSlot_t slots[DATASTORE_COALESCE_SLOT_COUNT];
+
+/**
+ * @brief   The pending write slots lock.
+ */
+static struct k_spinlock slotLock;
+
+/**
+ * @brief   Check if two datapoint ranges overlap.
+ *
+ * @param[in]   slot: The pending write slot.
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of values.
+ *
+ * @return  true if the ranges overlap, false otherwise.
+ */
+static inline bool isOverlapping(DatastoreCoalesceSlot_t *slot, DatapointType_t datapointType,
+                                 uint32_t datapointId, size_t valCount)
+{
+  return slot->datapointType == datapointType && datapointId < slot->datapointId + slot->valCount &&
+         slot->datapointId < datapointId + valCount;
+}
+
+int datastoreCoalesceWrite(DatapointType_t datapointType, uint32_t datapointId,
+                           DatapointData_t values[], size_t valCount, uint32_t *slotId)
+{
+  int err = -ENOSPC;
+  k_spinlock_key_t key;
+  DatastoreCoalesceSlot_t *slot;
+  DatastoreCoalesceSlot_t *freeSlot = NULL;
+
+  if(valCount == 0 || valCount > DATASTORE_COALESCE_MAX_VALUES)
+    return -EINVAL;
+
+  key = k_spin_lock(&slotLock);
+
+  for(uint32_t i = 0; i < DATASTORE_COALESCE_SLOT_COUNT; ++i)
+  {
+    slot = slots + i;
+
+    if(slot->state == COALESCE_SLOT_FREE)
+    {
+      if(!freeSlot)
+        freeSlot = slot;
+      continue;
+    }
+
+    if(slot->state == COALESCE_SLOT_TAKEN || !isOverlapping(slot, datapointType, datapointId, valCount))
+      continue;
+
+    /* Only the exact same range is replaced in place, a partial overlap must keep the queue order. */
+    if(slot->state == COALESCE_SLOT_PUBLISHED && !slot->isSealed &&
+       slot->datapointId == datapointId && slot->valCount == valCount)
+    {
+      memcpy(slot->values, values, valCount * sizeof(DatapointData_t));
+      k_spin_unlock(&slotLock, key);
+      return 0;
+    }
+
+    slot->isSealed = true;
+  }
+
+  if(!slotId)
+  {
+    err = -ENOENT;
+  }
+  else if(freeSlot)
+  {
+    freeSlot->state = COALESCE_SLOT_RESERVED;
+    freeSlot->isSealed = false;
+    freeSlot->datapointType = datapointType;
+    freeSlot->datapointId = datapointId;
+    freeSlot->valCount = valCount;
+    memcpy(freeSlot->values, values, valCount * sizeof(DatapointData_t));
+
+    *slotId = freeSlot - slots;
+    err = 1;
+  }
+
+  k_spin_unlock(&slotLock, key);
+
+  return err;
+}
+
+void datastoreCoalesceSeal(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+  k_spinlock_key_t key = k_spin_lock(&slotLock);
+
+  for(uint32_t i = 0; i < DATASTORE_COALESCE_SLOT_COUNT; ++i)
+  {
+    if((slots[i].state == COALESCE_SLOT_RESERVED || slots[i].state == COALESCE_SLOT_PUBLISHED) &&
+       isOverlapping(slots + i, datapointType, datapointId, valCount))
+      slots[i].isSealed = true;
+  }
+
+  k_spin_unlock(&slotLock, key);
+}
+
+void datastoreCoalescePublish(uint32_t slotId)
+{
+  k_spinlock_key_t key;
+  DatastoreCoalesceSlot_t *slot;
+
+  if(slotId >= DATASTORE_COALESCE_SLOT_COUNT)
+    return;
+
+  slot = slots + slotId;
+  key = k_spin_lock(&slotLock);
+
+  /* The service may have taken the slot before it was published, it is only freed now. */
+  if(slot->state == COALESCE_SLOT_RESERVED)
+    slot->state = COALESCE_SLOT_PUBLISHED;
+  else if(slot->state == COALESCE_SLOT_TAKEN)
+    slot->state = COALESCE_SLOT_FREE;
+
+  k_spin_unlock(&slotLock, key);
+}
+
+void datastoreCoalesceCancel(uint32_t slotId)
+{
+  k_spinlock_key_t key;
+
+  if(slotId >= DATASTORE_COALESCE_SLOT_COUNT)
+    return;
+
+  key = k_spin_lock(&slotLock);
+
+  /* Never published, no other write was coalesced into the slot. */
+  if(slots[slotId].state == COALESCE_SLOT_RESERVED)
+    slots[slotId].state = COALESCE_SLOT_FREE;
+
+  k_spin_unlock(&slotLock, key);
+}
+
+/**
+ * @brief   Release a pending write slot on the service side.
+ *
+ * @note    The slot lock must be held.
+ *
+ * @param[in]   slot: The pending write slot.
+ */
+static inline void releaseSlot(DatastoreCoalesceSlot_t *slot)
+{
+  slot->state = slot->state == COALESCE_SLOT_RESERVED ? COALESCE_SLOT_TAKEN : COALESCE_SLOT_FREE;
+}
+
+void datastoreCoalesceDiscard(uint32_t slotId)
+{
+  k_spinlock_key_t key;
+
+  if(slotId >= DATASTORE_COALESCE_SLOT_COUNT)
+    return;
+
+  key = k_spin_lock(&slotLock);
+
+  if(slots[slotId].state == COALESCE_SLOT_RESERVED || slots[slotId].state == COALESCE_SLOT_PUBLISHED)
+    releaseSlot(slots + slotId);
+
+  k_spin_unlock(&slotLock, key);
+}
+
+int datastoreCoalesceTake(uint32_t slotId, DatapointType_t *datapointType, uint32_t *datapointId,
+                          DatapointData_t values[], size_t *valCount)
+{
+  k_spinlock_key_t key;
+  DatastoreCoalesceSlot_t *slot;
+
+  if(slotId >= DATASTORE_COALESCE_SLOT_COUNT)
+    return -EINVAL;
+
+  slot = slots + slotId;
+  key = k_spin_lock(&slotLock);
+
+  if(slot->state != COALESCE_SLOT_RESERVED && slot->state != COALESCE_SLOT_PUBLISHED)
+  {
+    k_spin_unlock(&slotLock, key);
+    LOG_ERR("ERROR %d: pending write slot %d not in use", -ESRCH, slotId);
+    return -ESRCH;
+  }
+
+  *datapointType = slot->datapointType;
+  *datapointId = slot->datapointId;
+  *valCount = slot->valCount;
+  memcpy(values, slot->values, slot->valCount * sizeof(DatapointData_t));
+  releaseSlot(slot);
+
+  k_spin_unlock(&slotLock, key);
+
+  return 0;
+}
+
+/** @} */
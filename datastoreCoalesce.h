@@ -0,0 +1,91 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreCoalesce.h
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Write Coalescing
+ *
+ *            Datastore service pending write coalescing.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#ifndef DATASTORE_SRV_COALESCE
+#define DATASTORE_SRV_COALESCE
+
+#include <zephyr/kernel.h>
+
+#include "datastoreMeta.h"
+
+/**
+ * @brief   Coalesce a fire-and-forget write with a pending one.
+ *
+ * @note    When no pending write matches, a new pending write slot is reserved.
+ *          The caller must queue it then publish it, or cancel it if that fails.
+ *          A reserved slot is not open to coalescing until it is published.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values to write.
+ * @param[in]   valCount: The count of values to write.
+ * @param[out]  slotId: The new pending write slot ID (NULL, to only merge with a pending write).
+ *
+ * @return  0 if coalesced, 1 if a new slot must be queued, the error code
+ *          if the write cannot be coalesced.
+ */
+int datastoreCoalesceWrite(DatapointType_t datapointType, uint32_t datapointId,
+                           DatapointData_t values[], size_t valCount, uint32_t *slotId);
+
+/**
+ * @brief   Stop coalescing the pending writes overlapping a non-coalesced write.
+ *
+ * @note    This keeps a later write from jumping ahead of a non-coalesced
+ *          write queued in between.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The count of values.
+ */
+void datastoreCoalesceSeal(DatapointType_t datapointType, uint32_t datapointId, size_t valCount);
+
+/**
+ * @brief   Publish a queued pending write slot, opening it to coalescing.
+ *
+ * @param[in]   slotId: The pending write slot ID.
+ */
+void datastoreCoalescePublish(uint32_t slotId);
+
+/**
+ * @brief   Cancel a reserved pending write slot that could not be queued.
+ *
+ * @param[in]   slotId: The pending write slot ID.
+ */
+void datastoreCoalesceCancel(uint32_t slotId);
+
+/**
+ * @brief   Drop a queued pending write slot without applying it.
+ *
+ * @param[in]   slotId: The pending write slot ID.
+ */
+void datastoreCoalesceDiscard(uint32_t slotId);
+
+/**
+ * @brief   Take the latest values of a pending write and free its slot.
+ *
+ * @param[in]   slotId: The pending write slot ID.
+ * @param[out]  datapointType: The datapoint type.
+ * @param[out]  datapointId: The datapoint ID.
+ * @param[out]  values: The values output buffer (DATASTORE_COALESCE_MAX_VALUES long).
+ * @param[out]  valCount: The count of values.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreCoalesceTake(uint32_t slotId, DatapointType_t *datapointType, uint32_t *datapointId,
+                          DatapointData_t values[], size_t *valCount);
+
+#endif    /* DATASTORE_SRV_COALESCE */
+
+/** @} */
@@ -17,14 +17,156 @@
 #define DATASTORE_META
 
 #include <zephyr/kernel.h>
+#include <float.h>
 
 #define DATASTORE_LOGGER_NAME datastore
 
+/**
+ * @brief   The service thread stack size, in bytes.
+ *
+ * @note    Also the notification work queue stack size in direct write mode.
+ *          The subscription callbacks run on this stack: it holds the message
+ *          processing (about 300 bytes, a coalesced drain included), the
+ *          notification pass (about 200 bytes), the logging and the deepest
+ *          callback.
+ */
+#define DATASTORE_STACK_SIZE                                      (2048)
+
 /**
  * @brief   The message count in the datastore queue.
  */
 #define DATASTORE_MSG_COUNT                                       (10)
 
+/**
+ * @brief   The message count in the urgent lane queue.
+ */
+#define DATASTORE_URGENT_MSG_COUNT                                (4)
+
+/**
+ * @brief   The maximum count of values carried inside a write message.
+ */
+#define DATASTORE_MSG_INLINE_VALUES                               (4)
+
+/**
+ * @brief   The count of pool buffers for the writes too large to be inlined.
+ */
+#define DATASTORE_WRITE_POOL_COUNT                                (DATASTORE_MSG_COUNT)
+
+/**
+ * @brief   Lock-free MPSC ring ingress instead of the message queue (0: disabled, 1: enabled).
+ *
+ * @note    The ring skips the pending write coalescing and its lock. A producer
+ *          preempted between reserving a slot and publishing it stalls the
+ *          consumer on that lane, the urgent one included, until it runs again.
+ */
+#define DATASTORE_MPSC_INGRESS_ENABLED                            (0)
+
+/**
+ * @brief   The slot count of the ingress ring, a power of 2.
+ */
+#define DATASTORE_RING_SLOT_COUNT                                 (16)
+
+/**
+ * @brief   The slot count of the urgent lane ingress ring, a power of 2.
+ */
+#define DATASTORE_URGENT_RING_SLOT_COUNT                          (4)
+
+/**
+ * @brief   The slot count of the ISR write ring, a power of 2.
+ */
+#define DATASTORE_ISR_RING_SLOT_COUNT                             (16)
+
+/**
+ * @brief   The maximum count of values of an ISR write.
+ */
+#define DATASTORE_ISR_MAX_VALUES                                  (2)
+
+/**
+ * @brief   The event count of a button event ring, a power of 2.
+ */
+#define DATASTORE_EVENT_RING_SIZE                                 (8)
+
+/**
+ * @brief   The wait timeout of a write with the blocking policy set by the datapoint flags, in milliseconds.
+ */
+#define DATASTORE_BLOCK_TIMEOUT                                   (5)
+
+/**
+ * @brief   The count of pending fire-and-forget write slots available for coalescing.
+ */
+#define DATASTORE_COALESCE_SLOT_COUNT                             (DATASTORE_MSG_COUNT)
+
+/**
+ * @brief   The maximum count of values of a coalesced write.
+ */
+#define DATASTORE_COALESCE_MAX_VALUES                             (4)
+
+/**
+ * @brief   The maximum count of writes staged in a transaction.
+ */
+#define DATASTORE_TXN_MAX_WRITES                                  (8)
+
+/**
+ * @brief   The maximum count of values staged in a transaction.
+ */
+#define DATASTORE_TXN_MAX_VALUES                                  (16)
+
+/**
+ * @brief   The maximum number of copy attempts of a direct read.
+ */
+#define DATASTORE_SEQLOCK_MAX_RETRY                               (8)
+
+/**
+ * @brief   Double-buffered datapoint banks for consistent snapshots (0: disabled, 1: enabled).
+ */
+#define DATASTORE_SNAPSHOT_ENABLED                                (0)
+
+/**
+ * @brief   The count of datapoint banks.
+ */
+#if DATASTORE_SNAPSHOT_ENABLED
+#define DATASTORE_BANK_COUNT                                      (2)
+#else
+#define DATASTORE_BANK_COUNT                                      (1)
+#endif
+
+/**
+ * @brief   Per-CPU datapoint read replicas, SMP targets only (0: disabled, 1: enabled).
+ */
+#define DATASTORE_REPLICA_ENABLED                                 (0)
+
+/**
+ * @brief   Direct write mode, requests are served in the caller context (0: disabled, 1: enabled).
+ *
+ * @note    No service thread is created, the datapoints of each type are
+ *          guarded by a spinlock and the notifications are deferred to a
+ *          datastore work queue.
+ */
+#define DATASTORE_DIRECT_WRITE_ENABLED                            (0)
+
+/**
+ * @brief   The pending write coalescing enabled flag, message queue ingress only.
+ * @note    The coalescing policy falls back to dropping the newest write otherwise.
+ */
+#define DATASTORE_COALESCE_ENABLED                                (!DATASTORE_MPSC_INGRESS_ENABLED && \
+                                                                   !DATASTORE_DIRECT_WRITE_ENABLED)
+
+/**
+ * @brief   Reject the owner writes made from another thread than the claiming one (0: disabled, 1: enabled).
+ * @note    Enabled in debug builds only. The writes to owned datapoints through the
+ *          other write functions are always rejected.
+ */
+#ifdef CONFIG_ASSERT
+#define DATASTORE_OWNER_CHECK_ENABLED                             (1)
+#else
+#define DATASTORE_OWNER_CHECK_ENABLED                             (0)
+#endif
+
+/**
+ * @brief   The data cache line size, in bytes.
+ */
+#define DATASTORE_CACHE_LINE_SIZE                                 (32)
+
 /**
  * @brief   Datapoint no option flags.
  */
@@ -35,6 +177,49 @@
  */
 #define DATAPOINT_FLAG_NVM_MASK                                   (1 << 0)
 
+/**
+ * @brief   Datapoint relative deadband flag mask, floats only.
+ * @note    The deadband is then a fraction of the last notified value.
+ */
+#define DATAPOINT_FLAG_BAND_RELATIVE_MASK                         (1 << 1)
+
+/**
+ * @brief   Datapoint urgent lane flag mask.
+ * @note    The requests on the datapoint go through the urgent ingress lane.
+ */
+#define DATAPOINT_FLAG_URGENT_MASK                                (1 << 2)
+
+/**
+ * @brief   Datapoint backpressure policy shift.
+ */
+#define DATAPOINT_FLAG_POLICY_SHIFT                               (3)
+
+/**
+ * @brief   Datapoint backpressure policy mask, drop the newest write when no policy bit is set.
+ */
+#define DATAPOINT_FLAG_POLICY_MASK                                (3 << DATAPOINT_FLAG_POLICY_SHIFT)
+
+/**
+ * @brief   Datapoint drop oldest request policy flag mask.
+ */
+#define DATAPOINT_FLAG_DROP_OLDEST_MASK                           (1 << DATAPOINT_FLAG_POLICY_SHIFT)
+
+/**
+ * @brief   Datapoint blocking write policy flag mask.
+ */
+#define DATAPOINT_FLAG_BLOCK_MASK                                 (2 << DATAPOINT_FLAG_POLICY_SHIFT)
+
+/**
+ * @brief   Datapoint coalescing write policy flag mask.
+ */
+#define DATAPOINT_FLAG_COALESCE_MASK                              (3 << DATAPOINT_FLAG_POLICY_SHIFT)
+
+/**
+ * @brief   Datapoint event stream flag mask, button datapoints only.
+ * @note    Every write is queued and notified in order, even if the value did not change.
+ */
+#define DATAPOINT_FLAG_EVENT_MASK                                 (1 << 5)
+
 /**
  * @brief   First multi-state states.
  */
@@ -124,59 +309,76 @@ typedef struct
   uint32_t flags;                 /**< The datapoint flags. */
 } Datapoint_t;
 
+#ifdef DATASTORE_CATALOG_HEADER
+/**
+ * @brief   The application datapoint catalog, replacing the one below.
+ * @note    The header defines the six DATASTORE_<TYPE>_DATAPOINTS X-macros.
+ */
+#include DATASTORE_CATALOG_HEADER
+#else
 /**
  * @brief   Binary datapoint information X-macro.
- * @note    X(datapoint ID, option flag, default value)
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
  */
-#define DATASTORE_BINARY_DATAPOINTS       X(BINARY_FIRST_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, true) \
-                                          X(BINARY_SECOND_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, false) \
-                                          X(BINARY_THIRD_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, true) \
-                                          X(BINARY_FOURTH_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, false)
+#define DATASTORE_BINARY_DATAPOINTS       X(BINARY_FIRST_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, true, 0, 0, 1) \
+                                          X(BINARY_SECOND_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, false, 0, 0, 1) \
+                                          X(BINARY_THIRD_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, true, 0, 0, 1) \
+                                          X(BINARY_FOURTH_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, false, 0, 0, 1)
 
 /**
  * @brief   Button datapoint information X-macro.
- * @note    X(datapoint ID, option flag, default value)
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
+ *          DATAPOINT_FLAG_URGENT_MASK | DATAPOINT_FLAG_EVENT_MASK in the option flag puts the
+ *          writes in the urgent lane and notifies every press in order.
  */
-#define DATASTORE_BUTTON_DATAPOINTS       X(BUTTON_FIRST_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 0) \
-                                          X(BUTTON_SECOND_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, 0) \
-                                          X(BUTTON_THIRD_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 0) \
-                                          X(BUTTON_FOURTH_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, 0)
+#define DATASTORE_BUTTON_DATAPOINTS       X(BUTTON_FIRST_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 0, 0, BUTTON_DEPRESSED, BUTTON_LONG_PRESSED) \
+                                          X(BUTTON_SECOND_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, 0, 0, BUTTON_DEPRESSED, BUTTON_LONG_PRESSED) \
+                                          X(BUTTON_THIRD_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 0, 0, BUTTON_DEPRESSED, BUTTON_LONG_PRESSED) \
+                                          X(BUTTON_FOURTH_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, 0, 0, BUTTON_DEPRESSED, BUTTON_LONG_PRESSED)
 
 /**
  * @brief   Float datapoint information X-macro.
- * @note    X(datapoint ID, option flag, default value)
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
+ *          A 0.05f deadband notifies the changes larger than 0.05 only, with
+ *          DATAPOINT_FLAG_BAND_RELATIVE_MASK a 0.01f deadband notifies the changes
+ *          larger than 1%. DATAPOINT_FLAG_COALESCE_MASK merges the pending
+ *          fire-and-forget writes when the queue is full.
  */
-#define DATASTORE_FLOAT_DATAPOINTS        X(FLOAT_FIRST_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 0.0f) \
-                                          X(FLOAT_SECOND_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 1.0f) \
-                                          X(FLOAT_THIRD_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 2.0f) \
-                                          X(FLOAT_FOURTH_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 3.0f)
+#define DATASTORE_FLOAT_DATAPOINTS        X(FLOAT_FIRST_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 0.0f, 0.0f, -FLT_MAX, FLT_MAX) \
+                                          X(FLOAT_SECOND_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 1.0f, 0.0f, -FLT_MAX, FLT_MAX) \
+                                          X(FLOAT_THIRD_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 2.0f, 0.0f, -FLT_MAX, FLT_MAX) \
+                                          X(FLOAT_FOURTH_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, 3.0f, 0.0f, -FLT_MAX, FLT_MAX)
 
 /**
  * @brief   signed integer datapoint information X-macro.
- * @note    X(datapoint ID, option flag, default value)
+ * @note    X(datapoint ID, option flag, default value, hysteresis, minimum value, maximum value)
+ *          A hysteresis of 2 notifies any change in the direction of the last
+ *          notified one, and a reversal only when larger than 2.
  */
-#define DATASTORE_INT_DATAPOINTS          X(INT_FIRST_DATAPOINT,     DATAPOINT_FLAG_NVM_MASK, -1) \
-                                          X(INT_SECOND_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK,  0) \
-                                          X(INT_THIRD_DATAPOINT,     DATAPOINT_FLAG_NVM_MASK,  1) \
-                                          X(INT_FOURTH_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK,  2)
+#define DATASTORE_INT_DATAPOINTS          X(INT_FIRST_DATAPOINT,     DATAPOINT_FLAG_NVM_MASK, -1, 0, INT32_MIN, INT32_MAX) \
+                                          X(INT_SECOND_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK,  0, 0, INT32_MIN, INT32_MAX) \
+                                          X(INT_THIRD_DATAPOINT,     DATAPOINT_FLAG_NVM_MASK,  1, 0, INT32_MIN, INT32_MAX) \
+                                          X(INT_FOURTH_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK,  2, 0, INT32_MIN, INT32_MAX)
 
 /**
  * @brief   Multi-state datapoint information X-macro.
- * @note    X(datapoint ID, option flag, default value)
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
  */
-#define DATASTORE_MULTI_STATE_DATAPOINTS  X(MULTI_STATE_FIRST_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_FIRST_STATE_2) \
-                                          X(MULTI_STATE_SECOND_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_SECOND_STATE_4) \
-                                          X(MULTI_STATE_THIRD_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_THIRD_STATE_1) \
-                                          X(MULTI_STATE_FOURTH_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_FOURTH_STATE_3)
+#define DATASTORE_MULTI_STATE_DATAPOINTS  X(MULTI_STATE_FIRST_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_FIRST_STATE_2, 0, 0, MULTI_STATE_FIRST_STATE_COUNT - 1) \
+                                          X(MULTI_STATE_SECOND_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_SECOND_STATE_4, 0, 0, MULTI_STATE_SECOND_STATE_COUNT - 1) \
+                                          X(MULTI_STATE_THIRD_DATAPOINT,  DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_THIRD_STATE_1, 0, 0, MULTI_STATE_THIRD_STATE_COUNT - 1) \
+                                          X(MULTI_STATE_FOURTH_DATAPOINT, DATAPOINT_FLAG_NVM_MASK, MULTI_STATE_FOURTH_STATE_3, 0, 0, MULTI_STATE_FOURTH_STATE_COUNT - 1)
 
 /**
  * @brief   Unsigned integer datapoint information X-macro.
- * @note    X(datapoint ID, option flag, default value)
+ * @note    X(datapoint ID, option flag, default value, hysteresis, minimum value, maximum value)
+ *          The hysteresis works as for the signed integers.
  */
-#define DATASTORE_UINT_DATAPOINTS         X(UINT_FIRST_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK, 0) \
-                                          X(UINT_SECOND_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 1) \
-                                          X(UINT_THIRD_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK, 2) \
-                                          X(UINT_FOURTH_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 3)
+#define DATASTORE_UINT_DATAPOINTS         X(UINT_FIRST_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK, 0, 0, 0, UINT32_MAX) \
+                                          X(UINT_SECOND_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 1, 0, 0, UINT32_MAX) \
+                                          X(UINT_THIRD_DATAPOINT,    DATAPOINT_FLAG_NVM_MASK, 2, 0, 0, UINT32_MAX) \
+                                          X(UINT_FOURTH_DATAPOINT,   DATAPOINT_FLAG_NVM_MASK, 3, 0, 0, UINT32_MAX)
+#endif
 
 #endif    /* DATASTORE_META */
 
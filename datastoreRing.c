@@ -0,0 +1,130 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreRing.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Ring Implementation
+ *
+ *            Implementation of the lock-free multi-producer/single-consumer
+ *            ring. Producers reserve a slot with a compare-and-swap on the
+ *            head and publish it through the slot sequence number, so no
+ *            kernel lock is ever taken on the put path.
+ *
+ * @ingroup   datastore
+ * @{
+ */
+
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+#include "datastoreRing.h"
+
+/* Setting module logging */
+LOG_MODULE_DECLARE(DATASTORE_LOGGER_NAME);
+
+/**
+ * @brief   Get the signed distance between two ring positions.
+ *
+ * @param lhs     The left hand side position.
+ * @param rhs     The right hand side position.
+ *
+ * @return  The distance, safe across the position wrap around.
+ */
+static inline int32_t getDistance(atomic_val_t lhs, atomic_val_t rhs)
+{
+  return (int32_t)((uint32_t)lhs - (uint32_t)rhs);
+}
+
+void datastoreRingInit(DatastoreRing_t *ring)
+{
+  atomic_set(&ring->head, 0);
+  atomic_set(&ring->tail, 0);
+
+  for(size_t i = 0; i < ring->slotCount; ++i)
+    atomic_set(ring->seqs + i, i);
+}
+
+int datastoreRingPut(DatastoreRing_t *ring, const void *element)
+{
+  int32_t distance;
+  size_t slot;
+  atomic_val_t pos = atomic_get(&ring->head);
+
+  for(;;)
+  {
+    slot = pos & (ring->slotCount - 1);
+    distance = getDistance(atomic_get(ring->seqs + slot), pos);
+
+    if(distance == 0)
+    {
+      if(atomic_cas(&ring->head, pos, pos + 1))
+        break;
+    }
+    else if(distance < 0)
+    {
+      return -ENOMSG;
+    }
+
+    pos = atomic_get(&ring->head);
+  }
+
+  memcpy(ring->buffer + slot * ring->elementSize, element, ring->elementSize);
+  atomic_set(ring->seqs + slot, pos + 1);
+
+  datastoreDoorbellRing(ring->doorbell);
+
+  return 0;
+}
+
+int datastoreRingGet(DatastoreRing_t *ring, void *element)
+{
+  atomic_val_t pos = atomic_get(&ring->tail);
+  size_t slot = pos & (ring->slotCount - 1);
+
+  if(getDistance(atomic_get(ring->seqs + slot), pos + 1) < 0)
+    return -ENOMSG;
+
+  memcpy(element, ring->buffer + slot * ring->elementSize, ring->elementSize);
+
+  atomic_set(ring->seqs + slot, pos + ring->slotCount);
+  atomic_set(&ring->tail, pos + 1);
+
+  return 0;
+}
+
+bool datastoreRingIsEmpty(DatastoreRing_t *ring)
+{
+  atomic_val_t pos = atomic_get(&ring->tail);
+  size_t slot = pos & (ring->slotCount - 1);
+
+  return getDistance(atomic_get(ring->seqs + slot), pos + 1) < 0;
+}
+
+size_t datastoreRingUsedCount(DatastoreRing_t *ring)
+{
+  return getDistance(atomic_get(&ring->head), atomic_get(&ring->tail));
+}
+
+void datastoreDoorbellArm(DatastoreDoorbell_t *doorbell)
+{
+  atomic_set(&doorbell->isSleeping, 1);
+}
+
+void datastoreDoorbellCancel(DatastoreDoorbell_t *doorbell)
+{
+  atomic_set(&doorbell->isSleeping, 0);
+}
+
+int datastoreDoorbellWait(DatastoreDoorbell_t *doorbell, k_timeout_t timeout)
+{
+  return k_sem_take(&doorbell->sem, timeout);
+}
+
+void datastoreDoorbellRing(DatastoreDoorbell_t *doorbell)
+{
+  if(atomic_get(&doorbell->isSleeping) && atomic_cas(&doorbell->isSleeping, 1, 0))
+    k_sem_give(&doorbell->sem);
+}
+
+/** @} */
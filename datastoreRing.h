@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreRing.h
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Ring
+ *
+ *            Datastore service lock-free multi-producer/single-consumer ring.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#ifndef DATASTORE_SRV_RING
+#define DATASTORE_SRV_RING
+
+#include <zephyr/kernel.h>
+
+/**
+ * @brief   The ring consumer doorbell.
+ * @note    Shared by every ring the consumer waits on. Producers only touch
+ *          the semaphore when the consumer is about to sleep.
+ */
+typedef struct
+{
+  atomic_t isSleeping;                  /**< The consumer sleeping flag */
+  struct k_sem sem;                     /**< The consumer wake up semaphore */
+} DatastoreDoorbell_t;
+
+/**
+ * @brief   The multi-producer/single-consumer ring.
+ */
+typedef struct
+{
+  size_t slotCount;                     /**< The count of slots, a power of 2 */
+  size_t elementSize;                   /**< The element size */
+  atomic_t head;                        /**< The next slot to reserve */
+  atomic_t tail;                        /**< The next slot to consume */
+  atomic_t *seqs;                       /**< The slot sequence numbers */
+  uint8_t *buffer;                      /**< The element buffer */
+  DatastoreDoorbell_t *doorbell;        /**< The consumer doorbell */
+} DatastoreRing_t;
+
+/**
+ * @brief   Define a doorbell.
+ *
+ * @param name          The doorbell name.
+ */
+#define DATASTORE_DOORBELL_DEFINE(name) \
+  DatastoreDoorbell_t name = {.isSleeping = ATOMIC_INIT(0), .sem = Z_SEM_INITIALIZER(name.sem, 0, 1)}
+
+/**
+ * @brief   Define a ring.
+ *
+ * @param name          The ring name.
+ * @param elemSize      The element size.
+ * @param count         The count of slots, a power of 2.
+ * @param bell          The consumer doorbell.
+ */
+#define DATASTORE_RING_DEFINE(name, elemSize, count, bell) \
+  BUILD_ASSERT(((count) & ((count) - 1)) == 0, "the ring slot count must be a power of 2"); \
+  static atomic_t name##Seqs[(count)]; \
+  static uint8_t name##Buffer[(count) * (elemSize)] __aligned(4); \
+  DatastoreRing_t name = {.slotCount = (count), .elementSize = (elemSize), .seqs = name##Seqs, \
+                          .buffer = name##Buffer, .doorbell = (bell)}
+
+/**
+ * @brief   Initialize a ring.
+ *
+ * @param ring          The ring.
+ */
+void datastoreRingInit(DatastoreRing_t *ring);
+
+/**
+ * @brief   Put an element in the ring.
+ *
+ * @note    Lock-free, callable from any thread or ISR. The element is only
+ *          visible once its sequence is published: until then the consumer
+ *          stops at the slot, so a producer preempted in between stalls the
+ *          ring until it runs again.
+ *
+ * @param ring          The ring.
+ * @param element       The element.
+ *
+ * @return  0 if successful, -ENOMSG if the ring is full.
+ */
+int datastoreRingPut(DatastoreRing_t *ring, const void *element);
+
+/**
+ * @brief   Get an element from the ring.
+ *
+ * @note    Only the consumer calls this.
+ *
+ * @param ring          The ring.
+ * @param element       The element output buffer.
+ *
+ * @return  0 if successful, -ENOMSG if the ring is empty.
+ */
+int datastoreRingGet(DatastoreRing_t *ring, void *element);
+
+/**
+ * @brief   Check if the ring has an element ready for the consumer.
+ *
+ * @param ring          The ring.
+ *
+ * @return  true if the ring is empty, false otherwise.
+ */
+bool datastoreRingIsEmpty(DatastoreRing_t *ring);
+
+/**
+ * @brief   Get the count of elements in the ring.
+ *
+ * @param ring          The ring.
+ *
+ * @return  The count of reserved elements.
+ */
+size_t datastoreRingUsedCount(DatastoreRing_t *ring);
+
+/**
+ * @brief   Prepare the consumer to sleep on its doorbell.
+ *
+ * @note    The consumer must check its rings again after this and only then
+ *          wait with datastoreDoorbellWait(), or cancel with datastoreDoorbellCancel().
+ *
+ * @param doorbell      The doorbell.
+ */
+void datastoreDoorbellArm(DatastoreDoorbell_t *doorbell);
+
+/**
+ * @brief   Cancel an armed doorbell, the consumer found work after arming it.
+ *
+ * @param doorbell      The doorbell.
+ */
+void datastoreDoorbellCancel(DatastoreDoorbell_t *doorbell);
+
+/**
+ * @brief   Wait on an armed doorbell.
+ *
+ * @param doorbell      The doorbell.
+ * @param timeout       The wait timeout.
+ *
+ * @return  0 if rung, the error code otherwise.
+ */
+int datastoreDoorbellWait(DatastoreDoorbell_t *doorbell, k_timeout_t timeout);
+
+/**
+ * @brief   Wake the consumer if it sleeps on the doorbell.
+ *
+ * @note    Callable from any thread or ISR.
+ *
+ * @param doorbell      The doorbell.
+ */
+void datastoreDoorbellRing(DatastoreDoorbell_t *doorbell);
+
+#endif    /* DATASTORE_SRV_RING */
+
+/** @} */
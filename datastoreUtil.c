@@ -13,210 +13,1479 @@
  */
 
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/barrier.h>
+#include <stddef.h>
+#include <string.h>
 
 #include "datastoreUtil.h"
+#include "datastoreWaiter.h"
 
 /* Setting module logging */
-LOG_MODULE_REGISTER(DATASTORE_LOGGER_NAME);
+LOG_MODULE_DECLARE(DATASTORE_LOGGER_NAME);
 
 /**
- * @brief   Binary datapoints.
- * @note    Data is coming from X-macros in datastoreMeta.h
+ * @brief   The datapoint banks.
+ * @note    Data is coming from X-macros in datastoreMeta.h. The first bank is
+ *          the working bank at boot, the snapshot bank is synced from it at
+ *          initialization.
  */
-static Datapoint_t binaries[] = {
-#define X(name, flags, defaultVal) {.data.uintVal = defaultVal, .flags = flags}
+DatastoreSnapshot_t datastoreBanks[DATASTORE_BANK_COUNT] = {
+  {
+    .binaries = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.uintVal = defaultVal},
+      DATASTORE_BINARY_DATAPOINTS
+#undef X
+    },
+    .buttons = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.uintVal = defaultVal},
+      DATASTORE_BUTTON_DATAPOINTS
+#undef X
+    },
+    .floats = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.floatVal = defaultVal},
+      DATASTORE_FLOAT_DATAPOINTS
+#undef X
+    },
+    .ints = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.intVal = defaultVal},
+      DATASTORE_INT_DATAPOINTS
+#undef X
+    },
+    .multiStates = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.uintVal = defaultVal},
+      DATASTORE_MULTI_STATE_DATAPOINTS
+#undef X
+    },
+    .uints = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.uintVal = defaultVal},
+      DATASTORE_UINT_DATAPOINTS
+#undef X
+    },
+  },
+};
+
+/**
+ * @brief   The list of datapoint of each bank for each value type.
+ */
+static DatapointData_t *bankDatapoints[DATASTORE_BANK_COUNT][DATAPOINT_TYPE_COUNT] = {
+  {datastoreBanks[0].binaries, datastoreBanks[0].buttons, datastoreBanks[0].floats, datastoreBanks[0].ints, datastoreBanks[0].multiStates, datastoreBanks[0].uints},
+#if DATASTORE_SNAPSHOT_ENABLED
+  {datastoreBanks[1].binaries, datastoreBanks[1].buttons, datastoreBanks[1].floats, datastoreBanks[1].ints, datastoreBanks[1].multiStates, datastoreBanks[1].uints},
+#endif
+};
+
+/**
+ * @brief   The list of datapoint of the working bank for each value type.
+ * @note    This is where the service thread writes, the direct reads are done from here too.
+ */
+static DatapointData_t *datapoints[DATAPOINT_TYPE_COUNT] = {datastoreBanks[0].binaries, datastoreBanks[0].buttons,
+                                                            datastoreBanks[0].floats, datastoreBanks[0].ints,
+                                                            datastoreBanks[0].multiStates, datastoreBanks[0].uints};
+
+/**
+ * @brief   Binary datapoint option flags.
+ * @note    Data is coming from X-macros in datastoreMeta.h. The flags never
+ *          change, they are kept apart so the value arrays stay contiguous.
+ */
+static const uint32_t binaryFlags[BINARY_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) flagMask,
+  DATASTORE_BINARY_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Button datapoint option flags.
+ */
+static const uint32_t buttonFlags[BUTTON_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) flagMask,
+  DATASTORE_BUTTON_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Float datapoint option flags.
+ */
+static const uint32_t floatFlags[FLOAT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) flagMask,
+  DATASTORE_FLOAT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Signed integer datapoint option flags.
+ */
+static const uint32_t intFlags[INT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) flagMask,
+  DATASTORE_INT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Multi-state datapoint option flags.
+ */
+static const uint32_t multiStateFlags[MULTI_STATE_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) flagMask,
+  DATASTORE_MULTI_STATE_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Unsigned integer datapoint option flags.
+ */
+static const uint32_t uintFlags[UINT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) flagMask,
+  DATASTORE_UINT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   The list of option flags for each value type.
+ */
+static const uint32_t *datapointFlags[DATAPOINT_TYPE_COUNT] = {binaryFlags, buttonFlags, floatFlags,
+                                                               intFlags, multiStateFlags, uintFlags};
+
+#if DATASTORE_SNAPSHOT_ENABLED
+/**
+ * @brief   The working bank.
+ * @note    Only switched once the bank is fully up to date, the typed accessors read from it.
+ */
+DatastoreSnapshot_t *datastoreWorkingBank = datastoreBanks;
+#endif
+
+/**
+ * @brief   The offset of the datapoints of each value type in a bank.
+ */
+static const size_t bankTypeOffsets[DATAPOINT_TYPE_COUNT] = {
+  offsetof(DatastoreSnapshot_t, binaries), offsetof(DatastoreSnapshot_t, buttons),
+  offsetof(DatastoreSnapshot_t, floats), offsetof(DatastoreSnapshot_t, ints),
+  offsetof(DatastoreSnapshot_t, multiStates), offsetof(DatastoreSnapshot_t, uints),
+};
+
+#if DATASTORE_DIRECT_WRITE_ENABLED && DATASTORE_SNAPSHOT_ENABLED
+#error "The snapshot banks are committed by the service thread, disable the direct write mode"
+#endif
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+/**
+ * @brief   The datapoint lock of each value type.
+ */
+static struct k_spinlock datapointLocks[DATAPOINT_TYPE_COUNT];
+
+/**
+ * @brief   The datapoint lock key of each value type, owned by the lock holder.
+ */
+static k_spinlock_key_t datapointLockKeys[DATAPOINT_TYPE_COUNT];
+#endif
+
+#if DATASTORE_REPLICA_ENABLED && !defined(CONFIG_SMP)
+#error "The datapoint read replicas need an SMP target"
+#endif
+
+#if DATASTORE_REPLICA_ENABLED
+/**
+ * @brief   The per-CPU datapoint read replica.
+ * @note    Each replica starts on its own cache line so the replicas of
+ *          different CPUs never share one.
+ */
+typedef struct
+{
+  atomic_t seqs[DATAPOINT_TYPE_COUNT];  /**< The sequence counter of each value type */
+  DatastoreSnapshot_t bank;             /**< The replicated datapoints */
+} __aligned(DATASTORE_CACHE_LINE_SIZE) DatastoreReplica_t;
+
+/**
+ * @brief   The per-CPU datapoint read replicas.
+ */
+static DatastoreReplica_t replicas[CONFIG_MP_MAX_NUM_CPUS];
+#endif
+
+#if DATASTORE_SNAPSHOT_ENABLED
+/**
+ * @brief   The snapshot state.
+ * @note    Bit 0 is the published snapshot bank, the other bits are the count
+ *          of readers holding it. The banks are swapped only when that count
+ *          is 0, atomically with the check.
+ */
+static atomic_t snapshotState = ATOMIC_INIT(1);
+
+/**
+ * @brief   The first datapoint changed since the last commit for each value type.
+ */
+static uint32_t dirtyFirsts[DATAPOINT_TYPE_COUNT];
+
+/**
+ * @brief   The datapoint following the last one changed since the last commit for each value type.
+ */
+static uint32_t dirtyEnds[DATAPOINT_TYPE_COUNT];
+
+/**
+ * @brief   The commit pending flag.
+ */
+static atomic_t isCommitPending = ATOMIC_INIT(false);
+#endif
+
+/**
+ * @brief   The datapoint count of each value type.
+ */
+static size_t datapointCounts[DATAPOINT_TYPE_COUNT] = {BINARY_DATAPOINT_COUNT, BUTTON_DATAPOINT_COUNT, FLOAT_DATAPOINT_COUNT,
+                                                       INT_DATAPOINT_COUNT, MULTI_STATE_DATAPOINT_COUNT, UINT_DATAPOINT_COUNT};
+
+/**
+ * @brief   The started write counter of each value type.
+ * @note    A write is in progress while it differs from the finished write
+ *          counter. The counter pair stays valid with several writers, the
+ *          service thread and the datapoint owners.
+ */
+static atomic_t datapointWriteBegins[DATAPOINT_TYPE_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   The finished write counter of each value type.
+ */
+static atomic_t datapointWriteEnds[DATAPOINT_TYPE_COUNT] = {ATOMIC_INIT(0)};
+
+/**
+ * @brief   Binary datapoint last change timestamps.
+ */
+static uint32_t binaryTimestamps[BINARY_DATAPOINT_COUNT] = {0};
+
+/**
+ * @brief   Button datapoint last change timestamps.
+ */
+static uint32_t buttonTimestamps[BUTTON_DATAPOINT_COUNT] = {0};
+
+/**
+ * @brief   Float datapoint last change timestamps.
+ */
+static uint32_t floatTimestamps[FLOAT_DATAPOINT_COUNT] = {0};
+
+/**
+ * @brief   Signed integer datapoint last change timestamps.
+ */
+static uint32_t intTimestamps[INT_DATAPOINT_COUNT] = {0};
+
+/**
+ * @brief   Multi-state datapoint last change timestamps.
+ */
+static uint32_t multiStateTimestamps[MULTI_STATE_DATAPOINT_COUNT] = {0};
+
+/**
+ * @brief   Unsigned integer datapoint last change timestamps.
+ */
+static uint32_t uintTimestamps[UINT_DATAPOINT_COUNT] = {0};
+
+/**
+ * @brief   The list of last change timestamps for each value type.
+ * @note    The timestamps are kept apart from the values so the value arrays stay compact.
+ */
+static uint32_t *datapointTimestamps[DATAPOINT_TYPE_COUNT] = {binaryTimestamps, buttonTimestamps, floatTimestamps,
+                                                              intTimestamps, multiStateTimestamps, uintTimestamps};
+
+/**
+ * @brief   Float datapoint deadbands.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointData_t floatBands[FLOAT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.floatVal = band},
+  DATASTORE_FLOAT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Signed integer datapoint hysteresis widths.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointData_t intBands[INT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.intVal = band},
+  DATASTORE_INT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Unsigned integer datapoint hysteresis widths.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointData_t uintBands[UINT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.uintVal = band},
+  DATASTORE_UINT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   The list of deadbands or hysteresis widths for each value type (NULL, if the type has none).
+ */
+static const DatapointData_t *datapointBands[DATAPOINT_TYPE_COUNT] = {NULL, NULL, floatBands,
+                                                                      intBands, NULL, uintBands};
+
+/**
+ * @brief   The datapoint value limits.
+ */
+typedef struct
+{
+  DatapointData_t minVal;               /**< The minimum value */
+  DatapointData_t maxVal;               /**< The maximum value */
+} DatapointLimits_t;
+
+/**
+ * @brief   Binary datapoint value limits.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointLimits_t binaryLimits[BINARY_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {{.uintVal = minVal}, {.uintVal = maxVal}},
   DATASTORE_BINARY_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
- * @brief   Button datapoints.
- * @note    Data is coming from X-macros in datastoreMeta.h
+ * @brief   Button datapoint value limits.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
  */
-static Datapoint_t buttons[] = {
-#define X(name, flags, defaultVal) {.data.uintVal = defaultVal, .flags = flags}
+static const DatapointLimits_t buttonLimits[BUTTON_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {{.uintVal = minVal}, {.uintVal = maxVal}},
   DATASTORE_BUTTON_DATAPOINTS
-#undef
+#undef X
 };
 
 /**
- * @brief   Float datapoints.
- * @note    Data is coming from X-macros in datastoreMeta.h
+ * @brief   Float datapoint value limits.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointLimits_t floatLimits[FLOAT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {{.floatVal = minVal}, {.floatVal = maxVal}},
+  DATASTORE_FLOAT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Signed integer datapoint value limits.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointLimits_t intLimits[INT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {{.intVal = minVal}, {.intVal = maxVal}},
+  DATASTORE_INT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Multi-state datapoint value limits.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointLimits_t multiStateLimits[MULTI_STATE_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {{.uintVal = minVal}, {.uintVal = maxVal}},
+  DATASTORE_MULTI_STATE_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Unsigned integer datapoint value limits.
+ * @note    Data is coming from X-macros in datastoreMeta.h.
+ */
+static const DatapointLimits_t uintLimits[UINT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {{.uintVal = minVal}, {.uintVal = maxVal}},
+  DATASTORE_UINT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   The list of value limits for each value type.
+ */
+static const DatapointLimits_t *datapointLimits[DATAPOINT_TYPE_COUNT] = {binaryLimits, buttonLimits, floatLimits,
+                                                                         intLimits, multiStateLimits, uintLimits};
+
+/**
+ * @brief   Float datapoint values at the last notification.
+ */
+static DatapointData_t floatNotified[FLOAT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.floatVal = defaultVal},
+  DATASTORE_FLOAT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Signed integer datapoint values at the last notification.
+ */
+static DatapointData_t intNotified[INT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.intVal = defaultVal},
+  DATASTORE_INT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   Unsigned integer datapoint values at the last notification.
+ */
+static DatapointData_t uintNotified[UINT_DATAPOINT_COUNT] = {
+#define X(name, flagMask, defaultVal, band, minVal, maxVal) {.uintVal = defaultVal},
+  DATASTORE_UINT_DATAPOINTS
+#undef X
+};
+
+/**
+ * @brief   The list of values at the last notification for each value type (NULL, if the type has no deadband).
+ */
+static DatapointData_t *notifiedValues[DATAPOINT_TYPE_COUNT] = {NULL, NULL, floatNotified,
+                                                                intNotified, NULL, uintNotified};
+
+/**
+ * @brief   Signed integer datapoint directions at the last notification (1: rising, -1: falling, 0: none yet).
+ */
+static int8_t intTrends[INT_DATAPOINT_COUNT];
+
+/**
+ * @brief   Unsigned integer datapoint directions at the last notification (1: rising, -1: falling, 0: none yet).
+ */
+static int8_t uintTrends[UINT_DATAPOINT_COUNT];
+
+/**
+ * @brief   The list of directions at the last notification for each value type (NULL, if the type has no hysteresis).
+ */
+static int8_t *notifiedTrends[DATAPOINT_TYPE_COUNT] = {NULL, NULL, NULL, intTrends, NULL, uintTrends};
+
+/**
+ * @brief   Binary datapoint change records.
+ */
+static DatapointChange_t binaryChanges[BINARY_DATAPOINT_COUNT];
+
+/**
+ * @brief   Button datapoint change records.
+ */
+static DatapointChange_t buttonChanges[BUTTON_DATAPOINT_COUNT];
+
+/**
+ * @brief   Float datapoint change records.
+ */
+static DatapointChange_t floatChanges[FLOAT_DATAPOINT_COUNT];
+
+/**
+ * @brief   Signed integer datapoint change records.
+ */
+static DatapointChange_t intChanges[INT_DATAPOINT_COUNT];
+
+/**
+ * @brief   Multi-state datapoint change records.
+ */
+static DatapointChange_t multiStateChanges[MULTI_STATE_DATAPOINT_COUNT];
+
+/**
+ * @brief   Unsigned integer datapoint change records.
+ */
+static DatapointChange_t uintChanges[UINT_DATAPOINT_COUNT];
+
+/**
+ * @brief   The list of change records for each value type.
+ */
+static DatapointChange_t *datapointChanges[DATAPOINT_TYPE_COUNT] = {binaryChanges, buttonChanges, floatChanges,
+                                                                    intChanges, multiStateChanges, uintChanges};
+
+/**
+ * @brief   The changed datapoints of each value type, from the oldest to the latest change.
+ */
+static sys_dlist_t changeLists[DATAPOINT_TYPE_COUNT];
+
+/**
+ * @brief   The event ring of a datapoint.
+ */
+typedef struct
+{
+  uint32_t head;                                      /**< The count of events taken */
+  uint32_t tail;                                      /**< The count of events queued */
+  uint32_t overflowCount;                             /**< The count of events dropped on a full ring */
+  DatapointData_t events[DATASTORE_EVENT_RING_SIZE];  /**< The queued events */
+} DatapointEventRing_t;
+
+BUILD_ASSERT((DATASTORE_EVENT_RING_SIZE & (DATASTORE_EVENT_RING_SIZE - 1)) == 0,
+             "the event ring size must be a power of 2");
+
+/**
+ * @brief   Button datapoint event rings.
+ */
+static DatapointEventRing_t buttonEvents[BUTTON_DATAPOINT_COUNT];
+
+/**
+ * @brief   The last version given to a datapoint change for each value type.
+ */
+static uint32_t typeVersions[DATAPOINT_TYPE_COUNT] = {0};
+
+/**
+ * @brief   The binary datapoints changed since the last notification pass.
+ */
+static ATOMIC_DEFINE(binaryDirty, BINARY_DATAPOINT_COUNT);
+
+/**
+ * @brief   The button datapoints changed since the last notification pass.
+ */
+static ATOMIC_DEFINE(buttonDirty, BUTTON_DATAPOINT_COUNT);
+
+/**
+ * @brief   The float datapoints changed since the last notification pass.
+ */
+static ATOMIC_DEFINE(floatDirty, FLOAT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The signed integer datapoints changed since the last notification pass.
+ */
+static ATOMIC_DEFINE(intDirty, INT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The multi-state datapoints changed since the last notification pass.
+ */
+static ATOMIC_DEFINE(multiStateDirty, MULTI_STATE_DATAPOINT_COUNT);
+
+/**
+ * @brief   The unsigned integer datapoints changed since the last notification pass.
+ */
+static ATOMIC_DEFINE(uintDirty, UINT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The changed datapoints of each value type.
+ */
+static atomic_t *dirtySets[DATAPOINT_TYPE_COUNT] = {binaryDirty, buttonDirty, floatDirty,
+                                                    intDirty, multiStateDirty, uintDirty};
+
+/**
+ * @brief   The value types with changed datapoints.
+ */
+static ATOMIC_DEFINE(dirtyTypes, DATAPOINT_TYPE_COUNT);
+
+/**
+ * @brief   The nested notification suspension count.
+ */
+static atomic_t notifySuspendCount = ATOMIC_INIT(0);
+
+/**
+ * @brief   The binary datapoints claimed by an owner.
+ */
+static ATOMIC_DEFINE(binaryOwned, BINARY_DATAPOINT_COUNT);
+
+/**
+ * @brief   The button datapoints claimed by an owner.
+ */
+static ATOMIC_DEFINE(buttonOwned, BUTTON_DATAPOINT_COUNT);
+
+/**
+ * @brief   The float datapoints claimed by an owner.
+ */
+static ATOMIC_DEFINE(floatOwned, FLOAT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The signed integer datapoints claimed by an owner.
+ */
+static ATOMIC_DEFINE(intOwned, INT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The multi-state datapoints claimed by an owner.
+ */
+static ATOMIC_DEFINE(multiStateOwned, MULTI_STATE_DATAPOINT_COUNT);
+
+/**
+ * @brief   The unsigned integer datapoints claimed by an owner.
+ */
+static ATOMIC_DEFINE(uintOwned, UINT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The claimed datapoints of each value type.
+ */
+static atomic_t *ownedSets[DATAPOINT_TYPE_COUNT] = {binaryOwned, buttonOwned, floatOwned,
+                                                    intOwned, multiStateOwned, uintOwned};
+
+/**
+ * @brief   The lock serializing the ownership claims.
+ */
+static struct k_spinlock ownedLock;
+
+/**
+ * @brief   The binary datapoints written by their owner and not yet processed.
+ */
+static ATOMIC_DEFINE(binaryOwnedDirty, BINARY_DATAPOINT_COUNT);
+
+/**
+ * @brief   The button datapoints written by their owner and not yet processed.
+ */
+static ATOMIC_DEFINE(buttonOwnedDirty, BUTTON_DATAPOINT_COUNT);
+
+/**
+ * @brief   The float datapoints written by their owner and not yet processed.
+ */
+static ATOMIC_DEFINE(floatOwnedDirty, FLOAT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The signed integer datapoints written by their owner and not yet processed.
+ */
+static ATOMIC_DEFINE(intOwnedDirty, INT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The multi-state datapoints written by their owner and not yet processed.
+ */
+static ATOMIC_DEFINE(multiStateOwnedDirty, MULTI_STATE_DATAPOINT_COUNT);
+
+/**
+ * @brief   The unsigned integer datapoints written by their owner and not yet processed.
+ */
+static ATOMIC_DEFINE(uintOwnedDirty, UINT_DATAPOINT_COUNT);
+
+/**
+ * @brief   The owner written datapoints of each value type.
+ */
+static atomic_t *ownedDirtySets[DATAPOINT_TYPE_COUNT] = {binaryOwnedDirty, buttonOwnedDirty, floatOwnedDirty,
+                                                         intOwnedDirty, multiStateOwnedDirty, uintOwnedDirty};
+
+/**
+ * @brief   The value types with owner written datapoints not yet processed.
+ */
+static ATOMIC_DEFINE(ownedDirtyTypes, DATAPOINT_TYPE_COUNT);
+
+/**
+ * @brief   The datapoint count of the largest value type.
+ */
+#define DATASTORE_MAX_TYPE_COUNT                                                            \
+  MAX(MAX(MAX((size_t)BINARY_DATAPOINT_COUNT, (size_t)BUTTON_DATAPOINT_COUNT),              \
+          MAX((size_t)FLOAT_DATAPOINT_COUNT, (size_t)INT_DATAPOINT_COUNT)),                  \
+      MAX((size_t)MULTI_STATE_DATAPOINT_COUNT, (size_t)UINT_DATAPOINT_COUNT))
+
+/**
+ * @brief   The word count of the changed bitmap of the largest write.
+ */
+#define DATASTORE_CHANGED_MAX_WORDS                     DIV_ROUND_UP(DATASTORE_MAX_TYPE_COUNT, DATASTORE_CHANGED_WORD_BITS)
+
+/**
+ * @brief   The word count of the largest dirty set.
+ */
+#define DATASTORE_DIRTY_MAX_WORDS ATOMIC_BITMAP_SIZE(DATASTORE_MAX_TYPE_COUNT)
+
+/**
+ * @brief   The dirty set taken by the notification pass in progress.
+ */
+static atomic_t notifyDirty[DATASTORE_DIRTY_MAX_WORDS];
+
+/**
+ * @brief   The subscriptions for each value type.
+ */
+static GenericSubscription_t *subscriptions[DATAPOINT_TYPE_COUNT] = {NULL};
+
+/**
+ * @brief   The maximum count of subscriptions for each value type.
+ */
+static size_t subMaxCounts[DATAPOINT_TYPE_COUNT] = {0};
+
+/**
+ * @brief   The count of subscriptions for each value type.
+ */
+static size_t subCounts[DATAPOINT_TYPE_COUNT] = {0};
+
+/**
+ * @brief   The datastore buffer pool.
+ */
+static DatastoreBufferPool_t *bufPool;
+
+/**
+ * @brief   Check if a change must be notified.
+ *
+ * @note    Floats use a deadband: the change from the last notified value
+ *          must be larger than the band. Integers use a hysteresis: a change
+ *          in the direction of the last notified one is always notified, a
+ *          reversal must be larger than the band. A zero band lets any
+ *          change through.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   value: The new value.
+ *
+ * @return  true if the change must be notified, false otherwise.
+ */
+static bool isChangeNotified(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t value)
+{
+  DatapointData_t band;
+  DatapointData_t last;
+  float floatDelta;
+  float floatLimit;
+  int64_t intDelta;
+  int8_t trend;
+
+  if(!datapointBands[datapointType] || datapointBands[datapointType][datapointId].uintVal == 0)
+    return true;
+
+  band = datapointBands[datapointType][datapointId];
+  last = notifiedValues[datapointType][datapointId];
+
+  switch(datapointType)
+  {
+    case DATAPOINT_FLOAT:
+      floatDelta = value.floatVal - last.floatVal;
+      floatDelta = floatDelta < 0.0f ? -floatDelta : floatDelta;
+      floatLimit = band.floatVal;
+
+      if(datapointFlags[datapointType][datapointId] & DATAPOINT_FLAG_BAND_RELATIVE_MASK)
+        floatLimit *= last.floatVal < 0.0f ? -last.floatVal : last.floatVal;
+
+      return floatDelta > floatLimit;
+    case DATAPOINT_INT:
+      intDelta = (int64_t)value.intVal - last.intVal;
+      break;
+    default:
+      intDelta = (int64_t)value.uintVal - last.uintVal;
+      break;
+  }
+
+  trend = notifiedTrends[datapointType][datapointId];
+  if((intDelta > 0 && trend > 0) || (intDelta < 0 && trend < 0))
+    return true;
+
+  /* The widths are at most INT32_MAX and UINT32_MAX, both fit the 64-bit delta. */
+  return (intDelta < 0 ? -intDelta : intDelta) >
+         (datapointType == DATAPOINT_INT ? (int64_t)band.intVal : (int64_t)band.uintVal);
+}
+
+/**
+ * @brief   Record a notified value as the reference of the next changes.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   value: The notified value.
+ */
+static void markChangeNotified(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t value)
+{
+  DatapointData_t last;
+
+  if(!notifiedValues[datapointType])
+    return;
+
+  last = notifiedValues[datapointType][datapointId];
+
+  if(notifiedTrends[datapointType])
+  {
+    if(datapointType == DATAPOINT_INT)
+      notifiedTrends[datapointType][datapointId] = value.intVal > last.intVal ? 1 : -1;
+    else
+      notifiedTrends[datapointType][datapointId] = value.uintVal > last.uintVal ? 1 : -1;
+  }
+
+  notifiedValues[datapointType][datapointId] = value;
+}
+
+/**
+ * @brief   Lock the datapoints of a type.
+ *
+ * @note    In direct write mode the datapoints are guarded by a per type
+ *          spinlock, otherwise the scheduler is locked so a reader thread
+ *          never has to spin on a preempted service thread.
+ *
+ * @param[in]   datapointType: The datapoint type.
  */
-static Datapoint_t floats[] = {
-#define X(name, flags, defaultVal) {.data.floatVal = defaultVal, .flags = flags}
-  DATASTORE_FLOAT_DATAPOINTS
-#undef
-};
+static inline void lockDatapoints(DatapointType_t datapointType)
+{
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  datapointLockKeys[datapointType] = k_spin_lock(datapointLocks + datapointType);
+#else
+  ARG_UNUSED(datapointType);
+  k_sched_lock();
+#endif
+}
 
 /**
- * @brief   Singed integer datapoints.
- * @note    Data is coming from X-macros in datastoreMeta.h
+ * @brief   Unlock the datapoints of a type.
+ *
+ * @param[in]   datapointType: The datapoint type.
  */
-static Datapoint_t ints[] = {
-#define X(name, flags, defaultVal) {.data.intVal = defaultVal, .flags = flags}
-  DATASTORE_INT_DATAPOINTS
-#undef
-};
+static inline void unlockDatapoints(DatapointType_t datapointType)
+{
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  k_spin_unlock(datapointLocks + datapointType, datapointLockKeys[datapointType]);
+#else
+  ARG_UNUSED(datapointType);
+  k_sched_unlock();
+#endif
+}
 
 /**
- * @brief   Multi-state datapoints.
- * @note    Data is coming from X-macros in datastoreMeta.h
+ * @brief   Check if a datapoint of the subscription range is in a dirty set.
+ *
+ * @param[in]   sub: The subscription.
+ * @param[in]   dirtySet: The dirty set.
+ *
+ * @return  true if a datapoint of the subscription changed, false otherwise.
  */
-static Datapoint_t multiStates[] = {
-#define X(name, flags, defaultVal) {.data.uintVal = defaultVal, .flags = flags}
-  DATASTORE_MULTI_STATE_DATAPOINTS
-#undef
-};
+static inline bool isSubDirty(GenericSubscription_t *sub, atomic_t *dirtySet)
+{
+  for(uint32_t i = sub->datapointId; i < sub->datapointId + sub->valCount; ++i)
+  {
+    if(atomic_test_bit(dirtySet, i))
+      return true;
+  }
 
-/**
- * @brief   Unsigned integer datapoints.
- * @note    Data is coming from X-macros in datastoreMeta.h
- */
-static Datapoint_t uints[] = {
-#define X(name, flags, defaultVal) {.data.uintVal = defaultVal, .flags = flags}
-  DATASTORE_UINT_DATAPOINTS
-#undef
-};
+  return false;
+}
 
 /**
- * @brief   The list of datapoint for each value type.
+ * @brief   Call a subscription with the current values of its range.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   sub: The subscription.
+ * @param[in]   event: The event replacing the current value of its datapoint (NULL, if none).
+ * @param[in]   eventId: The event datapoint ID.
+ *
+ * @return  0 if successful, the error code otherwise.
  */
-static Datapoint_t **datapoints[DATAPOINT_TYPE_COUNT] = {binaries, buttons, floats, ints, multiStates, uints};
+static int notifySubscription(DatapointType_t datapointType, GenericSubscription_t *sub,
+                              const DatapointData_t *event, uint32_t eventId)
+{
+  int err;
+  DatapointData_t *buffer;
 
-/**
- * @brief   The datapoint count of each value type.
- */
-static size_t datapointCounts[DATAPOINT_TYPE_COUNT] = {FLOAT_DATAPOINT_COUNT, UINT_DATAPOINT_COUNT, INT_DATAPOINT_COUNT,
-                                                       MULTI_STATE_DATAPOINT_COUNT, BUTTON_DATAPOINT_COUNT};
+  buffer = datastoreBufPoolGet(bufPool);
+  if(!buffer)
+    return -ENOSPC;
+
+  /* Locked so a direct write in progress is never seen half applied. */
+  lockDatapoints(datapointType);
+
+  for(uint32_t i = sub->datapointId; i < sub->datapointId + sub->valCount; ++i)
+    buffer[i - sub->datapointId] = datapoints[datapointType][i];
+
+  unlockDatapoints(datapointType);
+
+  if(event)
+    buffer[eventId - sub->datapointId] = *event;
+
+  err = sub->callback(buffer, sub->valCount);
+
+  datastoreBufPoolReturn(bufPool, buffer);
+
+  return err;
+}
 
 /**
- * @brief   The binary subscriptions.
+ * @brief   Check if the datapoint ID and the value count are valid.
+ *
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The value count.
+ * @param[in]   datapointCount: The datapoint count.
+ *
+ * @return  true if the datapoint ID and value count are valid, false otherwise.
  */
-static GenericSubscription_t *binarySubs = NULL;
+static inline bool isDatapointIdAndValCountValid(uint32_t datapointId, size_t valCount, size_t datapointCount)
+{
+  return datapointId < datapointCount && valCount <= datapointCount - datapointId;
+}
 
 /**
- * @brief   The button subscriptions.
+ * @brief   Check if a value is within the limits of its datapoint.
+ *
+ * @note    A NaN float is never within its limits.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   value: The value.
+ *
+ * @return  true if the value is within the limits, false otherwise.
  */
-static GenericSubscription_t *buttonSubs = NULL;
+static inline bool isValueInLimits(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t value)
+{
+  const DatapointLimits_t *limits = datapointLimits[datapointType] + datapointId;
+
+  switch(datapointType)
+  {
+    case DATAPOINT_FLOAT:
+      return value.floatVal >= limits->minVal.floatVal && value.floatVal <= limits->maxVal.floatVal;
+    case DATAPOINT_INT:
+      return value.intVal >= limits->minVal.intVal && value.intVal <= limits->maxVal.intVal;
+    default:
+      return value.uintVal >= limits->minVal.uintVal && value.uintVal <= limits->maxVal.uintVal;
+  }
+}
 
 /**
- * @brief   The float subscriptions.
+ * @brief   Compute the result of a read-modify-write operation.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   op: The operation.
+ * @param[in]   value: The current value.
+ * @param[in]   operand: The operand.
+ * @param[in]   expected: The expected value of a compare-and-swap.
+ * @param[out]  result: The new value.
+ *
+ * @return  0 if successful, -EAGAIN if a compare-and-swap did not match, the error code otherwise.
  */
-static GenericSubscription_t *floatSubs = NULL;
+static int computeModifiedValue(DatapointType_t datapointType, DatastoreRmwOp_t op, DatapointData_t value,
+                                DatapointData_t operand, DatapointData_t expected, DatapointData_t *result)
+{
+  bool isFloat = datapointType == DATAPOINT_FLOAT;
+  bool isInt = datapointType == DATAPOINT_INT;
+
+  switch(op)
+  {
+    case DATASTORE_RMW_ADD:
+      if(isFloat)
+        result->floatVal = value.floatVal + operand.floatVal;
+      else
+        result->uintVal = value.uintVal + operand.uintVal;
+    break;
+    case DATASTORE_RMW_SUB:
+      if(isFloat)
+        result->floatVal = value.floatVal - operand.floatVal;
+      else
+        result->uintVal = value.uintVal - operand.uintVal;
+    break;
+    case DATASTORE_RMW_MIN:
+      if(isFloat)
+        result->floatVal = MIN(value.floatVal, operand.floatVal);
+      else if(isInt)
+        result->intVal = MIN(value.intVal, operand.intVal);
+      else
+        result->uintVal = MIN(value.uintVal, operand.uintVal);
+    break;
+    case DATASTORE_RMW_MAX:
+      if(isFloat)
+        result->floatVal = MAX(value.floatVal, operand.floatVal);
+      else if(isInt)
+        result->intVal = MAX(value.intVal, operand.intVal);
+      else
+        result->uintVal = MAX(value.uintVal, operand.uintVal);
+    break;
+    case DATASTORE_RMW_SET_BITS:
+    case DATASTORE_RMW_CLEAR_BITS:
+    case DATASTORE_RMW_TOGGLE_BITS:
+      if(isFloat)
+        return -ENOTSUP;
+
+      if(op == DATASTORE_RMW_SET_BITS)
+        result->uintVal = value.uintVal | operand.uintVal;
+      else if(op == DATASTORE_RMW_CLEAR_BITS)
+        result->uintVal = value.uintVal & ~operand.uintVal;
+      else
+        result->uintVal = value.uintVal ^ operand.uintVal;
+    break;
+    case DATASTORE_RMW_CAS:
+      if(value.uintVal != expected.uintVal)
+        return -EAGAIN;
+
+      *result = operand;
+    break;
+    default:
+      return -ENOTSUP;
+  }
+
+  return 0;
+}
+
+BUILD_ASSERT(sizeof(DatapointData_t) == sizeof(uint32_t), "datapoint values must be compared as 32-bit words");
 
 /**
- * @brief   The unsigned integer subscriptions.
+ * @brief   Compare incoming values against the current ones.
+ *
+ * @note    The loop is branch free: each element XOR is OR-reduced and its
+ *          non-zero test is packed into the changed bitmap, so compilers can
+ *          vectorize it on targets with SIMD.
+ *
+ * @param[in]   current: The current values.
+ * @param[in]   incoming: The incoming values.
+ * @param[in]   count: The value count.
+ * @param[out]  changed: The changed bitmap, one bit per value.
+ *
+ * @return  Non-zero if at least one value differs, 0 otherwise.
  */
-static GenericSubscription_t *uintSubs = NULL;
+static inline uint32_t diffDatapoints(const DatapointData_t current[], const DatapointData_t incoming[],
+                                      size_t count, uint32_t changed[])
+{
+  uint32_t diff;
+  uint32_t anyDiff = 0;
+
+  memset(changed, 0, DIV_ROUND_UP(count, DATASTORE_CHANGED_WORD_BITS) * sizeof(uint32_t));
+
+  for(size_t i = 0; i < count; ++i)
+  {
+    diff = current[i].uintVal ^ incoming[i].uintVal;
+    anyDiff |= diff;
+    changed[i / DATASTORE_CHANGED_WORD_BITS] |= (uint32_t)(diff != 0) << (i % DATASTORE_CHANGED_WORD_BITS);
+  }
+
+  return anyDiff;
+}
 
 /**
- * @brief   The signed integer subscriptions.
+ * @brief   Start writing the datapoints of a type.
+ *
+ * @note    The datapoints of the type must be locked, or owned by the caller.
+ *
+ * @param[in]   datapointType: The datapoint type.
  */
-static GenericSubscription_t *intSubs = NULL;
+static inline void beginDatapointWrite(DatapointType_t datapointType)
+{
+  atomic_inc(datapointWriteBegins + datapointType);
+}
 
 /**
- * @brief   The multi-state subscriptions.
+ * @brief   Finish writing the datapoints of a type.
+ *
+ * @param[in]   datapointType: The datapoint type.
  */
-static GenericSubscription_t *multiStateSubs = NULL;
+static inline void endDatapointWrite(DatapointType_t datapointType)
+{
+  atomic_inc(datapointWriteEnds + datapointType);
+}
 
 /**
- * @brief   The list of subscription for each value type.
+ * @brief   Check if a datapoint version is newer than a cursor.
+ *
+ * @note    The comparison survives the version counter wrap around.
+ *
+ * @param[in]   version: The datapoint version.
+ * @param[in]   cursor: The cursor.
+ *
+ * @return  true if the version is newer than the cursor, false otherwise.
  */
-static GenericSubscription_t *subscriptions[DATAPOINT_TYPE_COUNT] = {binarySubs, buttonSubs, floatSubs, intSubs, multiStateSubs, uintSubs};
+static inline bool isVersionNewer(uint32_t version, uint32_t cursor)
+{
+  return (int32_t)(version - cursor) > 0;
+}
 
 /**
- * @brief   The maximum count of subscriptions for each value type.
+ * @brief   Record a datapoint value change.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
  */
-static size_t subMaxCounts[DATAPOINT_TYPE_COUNT] = {0};
+static inline void recordDatapointChange(DatapointType_t datapointType, uint32_t datapointId)
+{
+  DatapointChange_t *change = datapointChanges[datapointType] + datapointId;
+
+  change->version = ++typeVersions[datapointType];
+
+  if(sys_dnode_is_linked(&change->node))
+    sys_dlist_remove(&change->node);
+
+  sys_dlist_append(changeLists + datapointType, &change->node);
+}
 
 /**
- * @brief   The count of subscriptions for each value type.
+ * @brief   Get the datapoints of a type in a bank.
+ *
+ * @param[in]   bank: The bank.
+ * @param[in]   datapointType: The datapoint type.
+ *
+ * @return  The datapoints of the type.
  */
-static size_t subCounts[DATAPOINT_TYPE_COUNT] = {0};
+static inline DatapointData_t *getBankDatapoints(DatastoreSnapshot_t *bank, DatapointType_t datapointType)
+{
+  return (DatapointData_t *)((uint8_t *)bank + bankTypeOffsets[datapointType]);
+}
 
+#if DATASTORE_REPLICA_ENABLED
 /**
- * @brief   The datastore buffer pool.
+ * @brief   Publish changed datapoints into every CPU read replica.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   first: The first changed datapoint.
+ * @param[in]   end: The datapoint following the last changed one.
  */
-static DatastoreBufferPool_t *bufPool;
+static void publishReplicas(DatapointType_t datapointType, uint32_t first, uint32_t end)
+{
+  DatastoreReplica_t *replica;
+
+  k_sched_lock();
+
+  for(uint32_t cpu = 0; cpu < arch_num_cpus(); ++cpu)
+  {
+    replica = replicas + cpu;
+
+    atomic_inc(replica->seqs + datapointType);
+    memcpy(getBankDatapoints(&replica->bank, datapointType) + first, datapoints[datapointType] + first,
+           (end - first) * sizeof(DatapointData_t));
+    atomic_inc(replica->seqs + datapointType);
+  }
+
+  k_sched_unlock();
+}
 
 /**
- * @brief   Check if the float datapoint is in rage of the subscription.
+ * @brief   Read values from the read replica of the current CPU.
  *
+ * @note    The thread can migrate during the read, it then simply finishes
+ *          reading the replica of the previous CPU, which is just as valid.
+ *
+ * @param[in]   datapointType: The datapoint type.
  * @param[in]   datapointId: The datapoint ID.
- * @param[in]   sub: The subscription.
+ * @param[in]   valCount: The value count to read.
+ * @param[out]  values: The output buffer.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+static int readReplica(DatapointType_t datapointType, uint32_t datapointId, size_t valCount, DatapointData_t values[])
+{
+  atomic_val_t seq;
+  DatastoreReplica_t *replica = replicas + arch_curr_cpu()->id;
+  DatapointData_t *typeDatapoints = getBankDatapoints(&replica->bank, datapointType);
+
+  for(uint32_t retry = 0; retry < DATASTORE_SEQLOCK_MAX_RETRY; ++retry)
+  {
+    seq = atomic_get(replica->seqs + datapointType);
+    if(seq & 1)
+      continue;
+
+    for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+      values[i - datapointId] = typeDatapoints[i];
+
+    barrier_dmem_fence_full();
+
+    if(atomic_get(replica->seqs + datapointType) == seq)
+      return 0;
+  }
+
+  return -EAGAIN;
+}
+#endif
+
+/**
+ * @brief   Mark datapoints as changed since the last snapshot commit.
  *
- * @return  true if the datapoint is in range, false otherwise.
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   first: The first changed datapoint.
+ * @param[in]   end: The datapoint following the last changed one.
  */
-static inline bool isFloatDatapointInSubRange(uint32_t datapointId, DatastoreFloatSub_t *sub)
+static inline void markSnapshotDirty(DatapointType_t datapointType, uint32_t first, uint32_t end)
 {
-  return datapointId >= sub->datapointId && datapointId < sub->valCount;
+#if DATASTORE_SNAPSHOT_ENABLED
+  if(dirtyFirsts[datapointType] >= dirtyEnds[datapointType])
+  {
+    dirtyFirsts[datapointType] = first;
+    dirtyEnds[datapointType] = end;
+  }
+  else
+  {
+    dirtyFirsts[datapointType] = MIN(dirtyFirsts[datapointType], first);
+    dirtyEnds[datapointType] = MAX(dirtyEnds[datapointType], end);
+  }
+
+  atomic_set(&isCommitPending, true);
+#else
+  ARG_UNUSED(datapointType);
+  ARG_UNUSED(first);
+  ARG_UNUSED(end);
+#endif
 }
 
 /**
- * @brief   Check if the unsigned integer datapoint is in rage of the subscription.
+ * @brief   Check if a datapoint is an event stream.
  *
+ * @param[in]   datapointType: The datapoint type.
  * @param[in]   datapointId: The datapoint ID.
- * @param[in]   sub: The subscription.
  *
- * @return  true if the datapoint is in range, false otherwise.
+ * @return  true if the datapoint is an event stream, false otherwise.
  */
-static inline bool isUintDatapointInSubRange(uint32_t datapointId, DatastoreUintSub_t *sub)
+static inline bool isEventDatapoint(DatapointType_t datapointType, uint32_t datapointId)
 {
-  return datapointId >= sub->datapointId && datapointId < sub->valCount;
+  return datapointType == DATAPOINT_BUTTON && (datapointFlags[datapointType][datapointId] & DATAPOINT_FLAG_EVENT_MASK);
 }
 
 /**
- * @brief   Check if the signed integer datapoint is in rage of the subscription.
+ * @brief   Queue the written values of the event datapoints.
  *
- * @param[in]   datapointId: The datapoint ID.
- * @param[in]   sub: The subscription.
+ * @note    The datapoints of the type must be locked. A full ring drops its
+ *          oldest event, the latest ones always match the datapoint value.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   values: The values.
+ * @param[in]   valCount: The value count.
  *
- * @return  true if the datapoint is in range, false otherwise.
+ * @return  true if at least one event was queued, false otherwise.
  */
-static inline bool isIntDatapointInSubRange(uint32_t datapointId, DatastoreIntSub_t *sub)
+static bool queueEvents(DatapointType_t datapointType, uint32_t datapointId,
+                        const DatapointData_t values[], size_t valCount)
 {
-  return datapointId >= sub->datapointId && datapointId < sub->valCount;
+  bool isQueued = false;
+  DatapointEventRing_t *ring;
+
+  if(datapointType != DATAPOINT_BUTTON)
+    return false;
+
+  for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+  {
+    if(!isEventDatapoint(datapointType, i))
+      continue;
+
+    ring = buttonEvents + i;
+
+    if(ring->tail - ring->head == DATASTORE_EVENT_RING_SIZE)
+    {
+      ++ring->head;
+      ++ring->overflowCount;
+    }
+
+    ring->events[ring->tail & (DATASTORE_EVENT_RING_SIZE - 1)] = values[i - datapointId];
+    ++ring->tail;
+
+    atomic_set_bit(dirtySets[datapointType], i);
+    isQueued = true;
+  }
+
+  return isQueued;
 }
 
 /**
- * @brief   Check if the multi-state datapoint is in rage of the subscription.
+ * @brief   Take the oldest queued event of a datapoint.
  *
- * @param[in]   datapointId: The datapoint ID.
- * @param[in]   sub: The subscription.
+ * @param[in]   datapointId: The button datapoint ID.
+ * @param[out]  event: The event.
  *
- * @return  true if the datapoint is in range, false otherwise.
+ * @return  true if an event was taken, false if the ring is empty.
  */
-static inline bool isMultiStateDatapointInSubRange(uint32_t datapointId, DatastoreMultiStateSub_t *sub)
+static bool takeEvent(uint32_t datapointId, DatapointData_t *event)
 {
-  return datapointId >= sub->datapointId && datapointId < sub->valCount;
+  bool isTaken = false;
+  DatapointEventRing_t *ring = buttonEvents + datapointId;
+
+  lockDatapoints(DATAPOINT_BUTTON);
+
+  if(ring->head != ring->tail)
+  {
+    *event = ring->events[ring->head & (DATASTORE_EVENT_RING_SIZE - 1)];
+    ++ring->head;
+    isTaken = true;
+  }
+
+  unlockDatapoints(DATAPOINT_BUTTON);
+
+  return isTaken;
 }
 
 /**
- * @brief   Check if the button datapoint is in rage of the subscription.
+ * @brief   Deliver the queued events of the dirty event datapoints, in order.
  *
- * @param[in]   datapointId: The datapoint ID.
- * @param[in]   sub: The subscription.
+ * @note    The subscriptions covering an event datapoint are called once per
+ *          event. A delivered datapoint is removed from the dirty set, the
+ *          regular pass does not notify it again.
+ *
+ * @param[in]   subs: The button subscriptions.
+ * @param[in]   subCount: The button subscription count.
+ * @param[in]   dirty: The button dirty set of the pass.
  *
- * @return  true if the datapoint is in range, false otherwise.
+ * @return  0 if successful, the error code of the last failed subscription otherwise.
  */
-static inline bool isButtonDatapointInSubRange(uint32_t datapointId, DatastoreButtonSub_t *sub)
+static int notifyEvents(GenericSubscription_t *subs, size_t subCount, atomic_t dirty[])
 {
-  return datapointId >= sub->datapointId && datapointId < sub->valCount;
+  int err = 0;
+  int errSub;
+  DatapointData_t event;
+
+  for(uint32_t id = 0; id < BUTTON_DATAPOINT_COUNT; ++id)
+  {
+    if(!isEventDatapoint(DATAPOINT_BUTTON, id) || !atomic_test_bit(dirty, id))
+      continue;
+
+    /* Dirty without a queued event, like an owner write, the regular pass notifies it. */
+    if(!takeEvent(id, &event))
+      continue;
+
+    atomic_clear_bit(dirty, id);
+
+    do
+    {
+      for(size_t i = 0; i < subCount; ++i)
+      {
+        if(subs[i].isPaused || id < subs[i].datapointId || id >= subs[i].datapointId + subs[i].valCount)
+          continue;
+
+        errSub = notifySubscription(DATAPOINT_BUTTON, subs + i, &event, id);
+        if(errSub < 0)
+        {
+          err = errSub;
+          LOG_ERR("ERROR %d: event subscription %zu of datapoint %d failed", err, i, id);
+        }
+      }
+    } while(takeEvent(id, &event));
+  }
+
+  return err;
 }
 
 /**
- * @brief   Check if the datapoint ID and the value count are valid.
+ * @brief   Write datapoint values and do the change bookkeeping.
  *
- * @param[in]   datapointId: The datapoint ID.
- * @param[in]   valCount: The value count.
- * @param[in]   datapointCount: The datapoint count.
+ * @note    The datapoints of the type must be locked and the range valid.
  *
- * @return  true if the datapoint ID and value count are valid, false otherwise.
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   values: The values.
+ * @param[in]   valCount: The value count.
+ * @param[out]  needToNotify: The notification needed flag.
+ * @param[out]  changedOut: The changed bitmap output buffer (NULL, if not needed).
  */
-static inline bool isDatapointIdAndValCountValid(uint32_t datapointId, size_t valCount, size_t datapointCount)
+static void writeDatapoints(DatapointType_t datapointType, uint32_t datapointId,
+                            DatapointData_t values[], size_t valCount, bool *needToNotify,
+                            uint32_t changedOut[])
+{
+  uint32_t now;
+  uint32_t bits;
+  uint32_t id;
+  bool isChanged;
+  uint32_t changed[DATASTORE_CHANGED_MAX_WORDS];
+  uint32_t changedFirst = datapointId + valCount;
+  uint32_t changedEnd = datapointId;
+
+  *needToNotify = queueEvents(datapointType, datapointId, values, valCount);
+  if(*needToNotify)
+    atomic_set_bit(dirtyTypes, datapointType);
+
+  isChanged = diffDatapoints(datapoints[datapointType] + datapointId, values, valCount, changed);
+
+  if(changedOut)
+    memcpy(changedOut, changed, DIV_ROUND_UP(valCount, DATASTORE_CHANGED_WORD_BITS) * sizeof(uint32_t));
+
+  if(!isChanged)
+    return;
+
+  now = k_uptime_get_32();
+
+  beginDatapointWrite(datapointType);
+
+  memcpy(datapoints[datapointType] + datapointId, values, valCount * sizeof(DatapointData_t));
+
+  for(size_t word = 0; word < DIV_ROUND_UP(valCount, DATASTORE_CHANGED_WORD_BITS); ++word)
+  {
+    for(bits = changed[word]; bits != 0; bits &= bits - 1)
+    {
+      id = datapointId + word * DATASTORE_CHANGED_WORD_BITS + find_lsb_set(bits) - 1;
+
+      datapointTimestamps[datapointType][id] = now;
+      recordDatapointChange(datapointType, id);
+      changedFirst = MIN(changedFirst, id);
+      changedEnd = id + 1;
+
+      if(isChangeNotified(datapointType, id, values[id - datapointId]))
+      {
+        markChangeNotified(datapointType, id, values[id - datapointId]);
+
+        atomic_set_bit(dirtySets[datapointType], id);
+        *needToNotify = true;
+      }
+    }
+  }
+
+  endDatapointWrite(datapointType);
+
+  if(*needToNotify)
+    atomic_set_bit(dirtyTypes, datapointType);
+
+  markSnapshotDirty(datapointType, changedFirst, changedEnd);
+#if DATASTORE_REPLICA_ENABLED
+  publishReplicas(datapointType, changedFirst, changedEnd);
+#endif
+
+  /* Wake the waiters once every bank holds the values, a waiter registering now reads them. */
+  for(size_t word = 0; word < DIV_ROUND_UP(valCount, DATASTORE_CHANGED_WORD_BITS); ++word)
+  {
+    for(bits = changed[word]; bits != 0; bits &= bits - 1)
+    {
+      id = datapointId + word * DATASTORE_CHANGED_WORD_BITS + find_lsb_set(bits) - 1;
+      datastoreWaiterCheck(datapointType, id, values[id - datapointId]);
+    }
+  }
+}
+
+int datastoreUtilInitDatapoints(void)
+{
+  for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; ++i)
+    sys_dlist_init(changeLists + i);
+
+#if DATASTORE_SNAPSHOT_ENABLED
+  memcpy(datastoreBanks + 1, datastoreBanks, sizeof(DatastoreSnapshot_t));
+#endif
+
+#if DATASTORE_REPLICA_ENABLED
+  for(uint32_t cpu = 0; cpu < CONFIG_MP_MAX_NUM_CPUS; ++cpu)
+    memcpy(&replicas[cpu].bank, datastoreBanks, sizeof(DatastoreSnapshot_t));
+#endif
+
+  return 0;
+}
+
+uint32_t datastoreUtilGetFlags(DatapointType_t datapointType, uint32_t datapointId)
+{
+  if(datapointType >= DATAPOINT_TYPE_COUNT || datapointId >= datapointCounts[datapointType])
+    return 0;
+
+  return datapointFlags[datapointType][datapointId];
+}
+
+int datastoreUtilCommitSnapshot(void)
+{
+#if DATASTORE_SNAPSHOT_ENABLED
+  atomic_val_t front;
+  atomic_val_t working;
+  size_t first;
+  size_t end;
+
+  if(!atomic_get(&isCommitPending))
+    return 0;
+
+  front = atomic_get(&snapshotState) & 1;
+  working = !front;
+
+  /* Publish the working bank, only if no reader holds the current snapshot. */
+  if(!atomic_cas(&snapshotState, front, working))
+    return -EBUSY;
+
+  atomic_set(&isCommitPending, false);
+
+  /* The previous snapshot becomes the working bank, bring it up to date with the changes since the last commit. */
+  for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; ++i)
+  {
+    first = dirtyFirsts[i];
+    end = dirtyEnds[i];
+
+    lockDatapoints(i);
+    beginDatapointWrite(i);
+
+    if(first < end)
+      memcpy(bankDatapoints[front][i] + first, bankDatapoints[working][i] + first, (end - first) * sizeof(DatapointData_t));
+
+    datapoints[i] = bankDatapoints[front][i];
+
+    endDatapointWrite(i);
+    unlockDatapoints(i);
+
+    dirtyFirsts[i] = 0;
+    dirtyEnds[i] = 0;
+  }
+
+  datastoreWorkingBank = datastoreBanks + front;
+
+  return 0;
+#else
+  return 0;
+#endif
+}
+
+const DatastoreSnapshot_t *datastoreUtilAcquireSnapshot(void)
+{
+#if DATASTORE_SNAPSHOT_ENABLED
+  atomic_val_t state;
+
+  do
+  {
+    state = atomic_get(&snapshotState);
+  } while(!atomic_cas(&snapshotState, state, state + 2));
+
+  return datastoreBanks + (state & 1);
+#else
+  return NULL;
+#endif
+}
+
+bool datastoreUtilReleaseSnapshot(const DatastoreSnapshot_t *snapshot)
 {
-  return datapointId >= datapointCount && datapointId + valCount >= datapointCount;
+#if DATASTORE_SNAPSHOT_ENABLED
+  atomic_val_t state;
+
+  if(!snapshot)
+    return false;
+
+  state = atomic_sub(&snapshotState, 2) - 2;
+
+  /* The last reader gone, a commit deferred because of it can now be done. */
+  return state < 2 && atomic_get(&isCommitPending);
+#else
+  ARG_UNUSED(snapshot);
+  return false;
+#endif
 }
 
 int datastoreUtilAllocateSubs(DatapointType_t datapointType, size_t maxSubCount)
@@ -231,34 +1500,33 @@ int datastoreUtilAllocateSubs(DatapointType_t datapointType, size_t maxSubCount)
     return err;
   }
 
-  subs = subscriptions[datapointType];
-  subMaxCounts[datapointType] = maxSubCount;
-
+  if(maxSubCount == 0)
+    return 0;
+
   subs = k_malloc(maxSubCount * sizeof(GenericSubscription_t));
-  if(!floatSubs)
+  if(!subs)
   {
     err = -ENOSPC;
-    LOG_ERR("ERROR %d: unable to allocate memory for float subscription", err);
+    LOG_ERR("ERROR %d: unable to allocate memory for subscriptions of type %d", err, datapointType);
     return err;
   }
 
+  subscriptions[datapointType] = subs;
+  subMaxCounts[datapointType] = maxSubCount;
+
   return 0;
 }
 
-int datastoreUtilInitBufferPool(DatastoreMaxSubs_t *maxSubs)
+int datastoreUtilInitBufferPool(size_t maxSubs[DATAPOINT_TYPE_COUNT])
 {
-  size_t poolSize = maxSubs->maxFloatSubs;
-  size_t bufSize = FLOAT_DATAPOINT_COUNT;
-
-  poolSize = maxSubs->maxUintSubs > poolSize ? maxSubs->maxUintSubs : poolSize;
-  poolSize = maxSubs->maxIntSubs > poolSize ? maxSubs->maxIntSubs : poolSize;
-  poolSize = maxSubs->maxMultiStateSubs > poolSize ? maxSubs->maxMultiStateSubs : poolSize;
-  poolSize = maxSubs->maxButtonSubs > poolSize ? maxSubs->maxButtonSubs : poolSize;
+  size_t poolSize = 0;
+  size_t bufSize = 0;
 
-  bufSize = UINT_DATAPOINT_COUNT > bufSize ? UINT_DATAPOINT_COUNT : bufSize;
-  bufSize = INT_DATAPOINT_COUNT > bufSize ? INT_DATAPOINT_COUNT : bufSize;
-  bufSize = MULTI_STATE_DATAPOINT_COUNT > bufSize ? MULTI_STATE_DATAPOINT_COUNT : bufSize;
-  bufSize = BUTTON_DATAPOINT_COUNT > bufSize ? BUTTON_DATAPOINT_COUNT : bufSize;
+  for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; ++i)
+  {
+    poolSize = MAX(poolSize, maxSubs[i]);
+    bufSize = MAX(bufSize, datapointCounts[i]);
+  }
 
   bufPool = datastoreBufPoolInit(bufSize + DATASTORE_MSG_COUNT, poolSize + DATASTORE_MSG_COUNT);
   if(!bufPool)
@@ -271,26 +1539,16 @@ int datastoreUtilDoInitNotifications(void)
 {
   int err;
   GenericSubscription_t *subs;
-  size_t subCount;
-  DatapointData_t *buffer;
 
-  for(uint32_t i = 0; i < DATAPOINT_TYPE_COUNT; i++)
+  for(uint32_t type = 0; type < DATAPOINT_TYPE_COUNT; type++)
   {
-    subs = subscriptions[i];
-    subCount = subCounts[i];
+    subs = subscriptions[type];
 
-    for(uint32_t i = 0; i < subCount; ++i)
+    for(uint32_t i = 0; i < subCounts[type]; ++i)
     {
       if(!subs[i].isPaused)
       {
-        buffer = datastoreBufPoolGet(bufPool);
-        if(!buffer)
-          return -ENOSPC;
-
-        for(uint32_t j = subs[i].datapointId; j < subs[i].datapointId + subs[i].valCount; ++j)
-          buffer[j - subs[i].datapointId] = floats[j];
-
-        err = subs[i].callback(buffer, subs[i].valCount);
+        err = notifySubscription(type, subs + i, NULL, 0);
         if(err < 0)
           return err;
       }
@@ -318,7 +1576,7 @@ int datastoreUtilAddSubscription(DatapointType_t datapointType, GenericSubscript
     return err;
   }
 
-  if(subCounts[datapointType] + 1 >= subMaxCounts[datapointType])
+  if(subCounts[datapointType] >= subMaxCounts[datapointType])
   {
     err = -ENOSPC;
     LOG_ERR("ERROR %d: no more free float subscription record", err);
@@ -404,11 +1662,96 @@ int datastoreUtilUnpauseSubscription(DatapointType_t datapointType, GenericCallb
   return err;
 }
 
-int datastoreUtilNotify(DatapointType_t datapointType, uint32_t datapointId)
+bool datastoreUtilHasEvents(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
 {
-  int err;
+  if(datapointType != DATAPOINT_BUTTON ||
+     !isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+    return false;
+
+  for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+  {
+    if(isEventDatapoint(datapointType, i))
+      return true;
+  }
+
+  return false;
+}
+
+uint32_t datastoreUtilGetEventOverflowCount(uint32_t datapointId)
+{
+  if(datapointId >= BUTTON_DATAPOINT_COUNT)
+    return 0;
+
+  return buttonEvents[datapointId].overflowCount;
+}
+
+void datastoreUtilSuspendNotify(void)
+{
+  atomic_inc(&notifySuspendCount);
+}
+
+int datastoreUtilResumeNotify(void)
+{
+  atomic_val_t count;
+
+  do
+  {
+    count = atomic_get(&notifySuspendCount);
+    if(count == 0)
+      return -EALREADY;
+  } while(!atomic_cas(&notifySuspendCount, count, count - 1));
+
+  return count - 1 == 0 ? 1 : 0;
+}
+
+int datastoreUtilNotify(void)
+{
+  int err = 0;
+  int errSub;
   GenericSubscription_t *subs;
-  DatapointData_t *buffer = NULL;
+
+  /* The dirty sets keep accumulating until the notifications resume. */
+  if(atomic_get(&notifySuspendCount) != 0)
+    return 0;
+
+  for(uint32_t type = 0; type < DATAPOINT_TYPE_COUNT; ++type)
+  {
+    if(!atomic_test_and_clear_bit(dirtyTypes, type))
+      continue;
+
+    /* Take the dirty set first, a datapoint changing during the pass is notified by the next one. */
+    for(size_t i = 0; i < ATOMIC_BITMAP_SIZE(datapointCounts[type]); ++i)
+      notifyDirty[i] = atomic_clear(dirtySets[type] + i);
+
+    subs = subscriptions[type];
+
+    if(type == DATAPOINT_BUTTON)
+    {
+      errSub = notifyEvents(subs, subCounts[type], notifyDirty);
+      if(errSub < 0)
+        err = errSub;
+    }
+
+    for(uint32_t i = 0; i < subCounts[type]; ++i)
+    {
+      if(!subs[i].isPaused && isSubDirty(subs + i, notifyDirty))
+      {
+        errSub = notifySubscription(type, subs + i, NULL, 0);
+        if(errSub < 0)
+        {
+          err = errSub;
+          LOG_ERR("ERROR %d: subscription %u of type %u failed", err, i, type);
+        }
+      }
+    }
+  }
+
+  return err;
+}
+
+int datastoreUtilReadData(DatapointType_t datapointType, uint32_t datapointId, size_t valCount, DatapointData_t values[])
+{
+  int err;
 
   if(datapointType >= DATAPOINT_TYPE_COUNT)
   {
@@ -417,34 +1760,191 @@ int datastoreUtilNotify(DatapointType_t datapointType, uint32_t datapointId)
     return err;
   }
 
-  subs = subscriptions[datapointType];
+  if(!isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+  {
+    err = -ENOSPC;
+    LOG_ERR("ERROR %d: reading more value than available", err);
+    return err;
+  }
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  lockDatapoints(datapointType);
+#endif
+
+  memcpy(values, datapoints[datapointType] + datapointId, valCount * sizeof(DatapointData_t));
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  unlockDatapoints(datapointType);
+#endif
+
+  return 0;
+}
 
-  for(size_t i = 0; i < subCounts[datapointType]; ++i)
+int datastoreUtilReadBatch(DatastoreReadDesc_t descs[], size_t descCount)
+{
+  int err;
+
+  for(size_t i = 0; i < descCount; ++i)
   {
-    if(isFloatDatapointInSubRange(datapointId, subscriptions[datapointType] + i) && !subscriptions[datapointType][i].isPaused)
+    err = datastoreUtilReadData(descs[i].datapointType, descs[i].datapointId, descs[i].valCount, descs[i].values);
+    if(err < 0)
     {
-      buffer = datastoreBufPoolGet(bufPool);
-      if(!buffer)
-        return -ENOSPC;
+      LOG_ERR("ERROR %d: unable to read batch descriptor %zu", err, i);
+      return err;
+    }
+  }
 
-      for(uint32_t j = subs[i].datapointId; j < subs[i].datapointId + subs[i].valCount; ++j)
-        buffer[j - subs[i].datapointId] = floats[j];
+  return 0;
+}
 
-      err = subs[i].callback(buffer, subs[i].valCount);
-      if(err < 0)
-        return err;
-    }
+int datastoreUtilReadDataDirect(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                                DatapointData_t values[], uint32_t timestamps[])
+{
+  atomic_val_t seq;
+  DatapointData_t *typeDatapoints;
+  uint32_t *typeTimestamps;
+
+  if(datapointType >= DATAPOINT_TYPE_COUNT)
+    return -ENOTSUP;
+
+  if(!isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+    return -ENOSPC;
+
+#if DATASTORE_REPLICA_ENABLED
+  if(!timestamps)
+    return readReplica(datapointType, datapointId, valCount, values);
+#endif
+
+  typeTimestamps = datapointTimestamps[datapointType];
+
+  for(uint32_t retry = 0; retry < DATASTORE_SEQLOCK_MAX_RETRY; ++retry)
+  {
+    seq = atomic_get(datapointWriteEnds + datapointType);
+    if(atomic_get(datapointWriteBegins + datapointType) != seq)
+      continue;
+
+    typeDatapoints = datapoints[datapointType];
+
+    if(values)
+      memcpy(values, typeDatapoints + datapointId, valCount * sizeof(DatapointData_t));
+
+    if(timestamps)
+      memcpy(timestamps, typeTimestamps + datapointId, valCount * sizeof(uint32_t));
+
+    barrier_dmem_fence_full();
+
+    if(atomic_get(datapointWriteBegins + datapointType) == seq)
+      return 0;
+  }
+
+  return -EAGAIN;
+}
+
+int datastoreUtilReadChanges(DatastoreChangeQuery_t *query)
+{
+  int err;
+  sys_dlist_t *list;
+  sys_dnode_t *node;
+  sys_dnode_t *oldest = NULL;
+  DatapointChange_t *change;
+  uint32_t datapointId;
+
+  if(query->datapointType >= DATAPOINT_TYPE_COUNT)
+  {
+    err = -ENOTSUP;
+    LOG_ERR("ERROR %d: unsupported value type %d", err, query->datapointType);
+    return err;
   }
+
+  list = changeLists + query->datapointType;
+  query->count = 0;
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  lockDatapoints(query->datapointType);
+#endif
+
+  /* The list is sorted by version, walk back from the latest change to the oldest one after the cursor. */
+  for(node = sys_dlist_peek_tail(list); node; node = sys_dlist_peek_prev(list, node))
+  {
+    change = CONTAINER_OF(node, DatapointChange_t, node);
+    if(!isVersionNewer(change->version, query->cursor))
+      break;
+
+    oldest = node;
+  }
+
+  for(node = oldest; node && query->count < query->maxCount; node = sys_dlist_peek_next(list, node))
+  {
+    change = CONTAINER_OF(node, DatapointChange_t, node);
+    datapointId = change - datapointChanges[query->datapointType];
+
+    query->ids[query->count] = datapointId;
+    query->values[query->count] = datapoints[query->datapointType][datapointId];
+    query->cursor = change->version;
+    ++query->count;
+  }
+
+#if DATASTORE_DIRECT_WRITE_ENABLED
+  unlockDatapoints(query->datapointType);
+#endif
+
+  return 0;
 }
 
-Datapoint_t *datastoreUtilGetBuffer(void)
+int datastoreUtilCountOlderThan(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                                uint32_t maxAge, size_t *staleCount)
 {
-  return datastoreBufPoolGet(bufPool);
+  uint32_t now;
+  uint32_t *typeTimestamps;
+
+  if(datapointType >= DATAPOINT_TYPE_COUNT)
+    return -ENOTSUP;
+
+  if(!isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+    return -ENOSPC;
+
+  now = k_uptime_get_32();
+  typeTimestamps = datapointTimestamps[datapointType];
+  *staleCount = 0;
+
+  for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+  {
+    if(now - typeTimestamps[i] > maxAge)
+      ++(*staleCount);
+  }
+
+  return 0;
 }
 
-int datastoreUtilReadData(DatapointType_t datapointType, uint32_t datapointId, size_t valCount, DatapointData_t values[])
+int datastoreUtilValidateWrite(DatapointType_t datapointType, uint32_t datapointId,
+                               const DatapointData_t values[], size_t valCount)
+{
+  if(datapointType >= DATAPOINT_TYPE_COUNT)
+    return -ENOTSUP;
+
+  if(!isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+    return -ENOSPC;
+
+  if(!values)
+    return 0;
+
+  for(size_t i = 0; i < valCount; ++i)
+  {
+    if(!isValueInLimits(datapointType, datapointId + i, values[i]))
+      return -ERANGE;
+  }
+
+  return 0;
+}
+
+int datastoreUtilModifyData(DatapointType_t datapointType, uint32_t datapointId, DatastoreRmwOp_t op,
+                            DatapointData_t operand, DatapointData_t expected, DatapointData_t *oldValue,
+                            bool *needToNotify)
 {
   int err;
+  DatapointData_t value;
+
+  *needToNotify = false;
 
   if(datapointType >= DATAPOINT_TYPE_COUNT)
   {
@@ -453,21 +1953,254 @@ int datastoreUtilReadData(DatapointType_t datapointType, uint32_t datapointId, s
     return err;
   }
 
-  if(isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+  if(!isDatapointIdAndValCountValid(datapointId, 1, datapointCounts[datapointType]))
   {
     err = -ENOSPC;
-    LOG_ERR("ERROR %d: reading more value than available", err);
+    LOG_ERR("ERROR %d: modifying a value not available", err);
     return err;
   }
 
+  if(datastoreUtilIsRangeOwned(datapointType, datapointId, 1))
+  {
+    err = -EPERM;
+    LOG_ERR("ERROR %d: modifying a value owned by another thread", err);
+    return err;
+  }
+
+  lockDatapoints(datapointType);
+
+  value = datapoints[datapointType][datapointId];
+  if(oldValue)
+    *oldValue = value;
+
+  err = computeModifiedValue(datapointType, op, value, operand, expected, &value);
+  if(err == 0 && !isValueInLimits(datapointType, datapointId, value))
+    err = -ERANGE;
+
+  if(err == 0)
+    writeDatapoints(datapointType, datapointId, &value, 1, needToNotify, NULL);
+
+  unlockDatapoints(datapointType);
+
+  return err;
+}
+
+int datastoreUtilWriteTransaction(DatastoreTxn_t *txn, bool *needToNotify)
+{
+  int err = 0;
+  bool isWriteChanged;
+  DatastoreTxnWrite_t *write;
+
+  *needToNotify = false;
+
+  for(size_t i = 0; i < txn->writeCount; ++i)
+  {
+    write = txn->writes + i;
+
+    if(write->datapointType >= DATAPOINT_TYPE_COUNT ||
+       !isDatapointIdAndValCountValid(write->datapointId, write->valCount, datapointCounts[write->datapointType]))
+    {
+      err = -EINVAL;
+      LOG_ERR("ERROR %d: invalid transaction write %zu", err, i);
+      return err;
+    }
+
+    if(datastoreUtilIsRangeOwned(write->datapointType, write->datapointId, write->valCount))
+    {
+      err = -EPERM;
+      LOG_ERR("ERROR %d: transaction write %zu to an owned value", err, i);
+      return err;
+    }
+  }
+
+  /* No direct reader on this CPU sees the transaction half applied. */
+  k_sched_lock();
+
+  for(size_t i = 0; i < txn->writeCount; ++i)
+  {
+    write = txn->writes + i;
+
+    err = datastoreUtilWriteData(write->datapointType, write->datapointId, txn->values + write->valOffset,
+                                 write->valCount, &isWriteChanged, NULL);
+    if(err < 0)
+      break;
+
+    *needToNotify = *needToNotify || isWriteChanged;
+  }
+
+  k_sched_unlock();
+
+  return err;
+}
+
+int datastoreUtilClaimRange(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+  int err = 0;
+  k_spinlock_key_t key;
+
+  if(datapointType >= DATAPOINT_TYPE_COUNT)
+    return -ENOTSUP;
+
+  if(!isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+    return -ENOSPC;
+
+  key = k_spin_lock(&ownedLock);
+
   for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
-    values[i] = datapoints[datapointType][i];
+  {
+    if(atomic_test_bit(ownedSets[datapointType], i))
+    {
+      err = -EBUSY;
+      break;
+    }
+  }
 
-  return 0;
+  if(err == 0)
+  {
+    for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+      atomic_set_bit(ownedSets[datapointType], i);
+  }
+
+  k_spin_unlock(&ownedLock, key);
+
+  return err;
+}
+
+void datastoreUtilReleaseRange(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+  k_spinlock_key_t key = k_spin_lock(&ownedLock);
+
+  for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+    atomic_clear_bit(ownedSets[datapointType], i);
+
+  k_spin_unlock(&ownedLock, key);
+}
+
+bool datastoreUtilIsRangeOwned(DatapointType_t datapointType, uint32_t datapointId, size_t valCount)
+{
+  if(datapointType >= DATAPOINT_TYPE_COUNT ||
+     !isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+    return false;
+
+  for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+  {
+    if(atomic_test_bit(ownedSets[datapointType], i))
+      return true;
+  }
+
+  return false;
+}
+
+bool datastoreUtilWriteOwnedData(DatapointType_t datapointType, uint32_t datapointId,
+                                 DatapointData_t values[], size_t valCount)
+{
+  uint32_t now;
+  uint32_t bits;
+  uint32_t id;
+  uint32_t changed[DATASTORE_CHANGED_MAX_WORDS];
+
+  /* The lock keeps a preempted owner from leaving the write counters open. */
+  lockDatapoints(datapointType);
+
+  if(!diffDatapoints(datapoints[datapointType] + datapointId, values, valCount, changed))
+  {
+    unlockDatapoints(datapointType);
+    return false;
+  }
+
+  now = k_uptime_get_32();
+
+  beginDatapointWrite(datapointType);
+
+  memcpy(datapoints[datapointType] + datapointId, values, valCount * sizeof(DatapointData_t));
+
+  for(size_t word = 0; word < DIV_ROUND_UP(valCount, DATASTORE_CHANGED_WORD_BITS); ++word)
+  {
+    for(bits = changed[word]; bits != 0; bits &= bits - 1)
+    {
+      id = datapointId + word * DATASTORE_CHANGED_WORD_BITS + find_lsb_set(bits) - 1;
+
+      datapointTimestamps[datapointType][id] = now;
+      atomic_set_bit(ownedDirtySets[datapointType], id);
+    }
+  }
+
+  /* The finished write counter bump releases the values to the readers. */
+  endDatapointWrite(datapointType);
+
+  unlockDatapoints(datapointType);
+
+  atomic_set_bit(ownedDirtyTypes, datapointType);
+
+  return true;
+}
+
+bool datastoreUtilHasOwnedChanges(void)
+{
+  return atomic_get(ownedDirtyTypes) != 0;
+}
+
+void datastoreUtilProcessOwnedChanges(bool *needToNotify)
+{
+  unsigned long bits;
+  uint32_t id;
+  uint32_t changedFirst;
+  uint32_t changedEnd;
+  DatapointData_t value;
+
+  *needToNotify = false;
+
+  for(uint32_t type = 0; type < DATAPOINT_TYPE_COUNT; ++type)
+  {
+    if(!atomic_test_and_clear_bit(ownedDirtyTypes, type))
+      continue;
+
+    changedFirst = datapointCounts[type];
+    changedEnd = 0;
+
+    lockDatapoints(type);
+
+    for(size_t word = 0; word < ATOMIC_BITMAP_SIZE(datapointCounts[type]); ++word)
+    {
+      bits = (unsigned long)atomic_clear(ownedDirtySets[type] + word);
+
+      for(id = word * ATOMIC_BITS; bits != 0; ++id, bits >>= 1)
+      {
+        if(!(bits & 1))
+          continue;
+
+        value = datapoints[type][id];
+
+        recordDatapointChange(type, id);
+        datastoreWaiterCheck(type, id, value);
+        changedFirst = MIN(changedFirst, id);
+        changedEnd = MAX(changedEnd, id + 1);
+
+        if(isChangeNotified(type, id, value))
+        {
+          markChangeNotified(type, id, value);
+
+          atomic_set_bit(dirtySets[type], id);
+          atomic_set_bit(dirtyTypes, type);
+          *needToNotify = true;
+        }
+      }
+    }
+
+    if(changedFirst < changedEnd)
+    {
+      markSnapshotDirty(type, changedFirst, changedEnd);
+#if DATASTORE_REPLICA_ENABLED
+      publishReplicas(type, changedFirst, changedEnd);
+#endif
+    }
+
+    unlockDatapoints(type);
+  }
 }
 
 int datastoreUtilWriteData(DatapointType_t datapointType, uint32_t datapointId,
-                           DatapointData_t values[], size_t valCount, bool *needToNotify)
+                           DatapointData_t values[], size_t valCount, bool *needToNotify, uint32_t changed[])
 {
   int err;
 
@@ -478,24 +2211,24 @@ int datastoreUtilWriteData(DatapointType_t datapointType, uint32_t datapointId,
     return err;
   }
 
-  if(isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
+  if(!isDatapointIdAndValCountValid(datapointId, valCount, datapointCounts[datapointType]))
   {
     err = -ENOSPC;
     LOG_ERR("ERROR %d: writing more value than available", err);
     return err;
   }
 
-  *needToNotify = false;
-
-  for(uint32_t i = datapointId; i < datapointId + valCount; ++i)
+  if(datastoreUtilIsRangeOwned(datapointType, datapointId, valCount))
   {
-    if(datapoints[datapointType][i] != values[i])
-    {
-      datapoints[datapointType][i] = values[i];
-      *needToNotify = true;
-    }
+    err = -EPERM;
+    LOG_ERR("ERROR %d: writing a value owned by another thread", err);
+    return err;
   }
 
+  lockDatapoints(datapointType);
+  writeDatapoints(datapointType, datapointId, values, valCount, needToNotify, changed);
+  unlockDatapoints(datapointType);
+
   return 0;
 }
 
@@ -16,9 +16,16 @@
 #ifndef DATASTORE_SRV_UTIL
 #define DATASTORE_SRV_UTIL
 
+#include <zephyr/sys/dlist.h>
+
 #include "datastore.h"
 #include "datastoreBufferPool.h"
 
+/**
+ * @brief   The bit count of a changed bitmap word.
+ */
+#define DATASTORE_CHANGED_WORD_BITS                     (32)
+
 /**
  * @brief   The generic return buffer function.
  */
@@ -38,7 +45,59 @@ typedef struct
   size_t valCount;                      /**< The datapoint count */
   bool isPaused;                        /**< The paused subscription flag */
   GenericCallback_t callback;           /**< The subscription callback */
-} GenericSubscription_t
+} GenericSubscription_t;
+
+/**
+ * @brief   The datapoint change record.
+ */
+typedef struct
+{
+  sys_dnode_t node;                     /**< The node in the change list of the type */
+  uint32_t version;                     /**< The version of the last value change */
+} DatapointChange_t;
+
+/**
+ * @brief   Initialize the datapoint bookkeeping.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilInitDatapoints(void);
+
+/**
+ * @brief   Get the option flags of a datapoint.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ *
+ * @return  The flags, 0 if the datapoint does not exist.
+ */
+uint32_t datastoreUtilGetFlags(DatapointType_t datapointType, uint32_t datapointId);
+
+/**
+ * @brief   Publish the working datapoint bank as the new snapshot.
+ *
+ * @note    Nothing is done if the datapoints did not change since the last
+ *          commit, or if snapshots are disabled.
+ *
+ * @return  0 if successful, -EBUSY if a reader still holds the current snapshot.
+ */
+int datastoreUtilCommitSnapshot(void);
+
+/**
+ * @brief   Acquire the current snapshot.
+ *
+ * @return  The snapshot if successful, NULL otherwise.
+ */
+const DatastoreSnapshot_t *datastoreUtilAcquireSnapshot(void);
+
+/**
+ * @brief   Release a snapshot.
+ *
+ * @param[in]   snapshot: The snapshot.
+ *
+ * @return  true if a deferred commit can now be done, false otherwise.
+ */
+bool datastoreUtilReleaseSnapshot(const DatastoreSnapshot_t *snapshot);
 
 /**
  * @brief   Allocate the array for the float subscriptions.
@@ -50,6 +109,15 @@ typedef struct
  */
 int datastoreUtilAllocateSubs(DatapointType_t datapointType, size_t maxSubCount);
 
+/**
+ * @brief   Initialize the notification buffer pool.
+ *
+ * @param[in]   maxSubs: The maximum subscriptions for each datatype.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilInitBufferPool(size_t maxSubs[DATAPOINT_TYPE_COUNT]);
+
 /**
  * @brief   Do the initial notifications.
  *
@@ -88,14 +156,51 @@ int datastoreUtilPauseSubscription(DatapointType_t datapointType, GenericCallbac
 int datastoreUtilUnpauseSubscription(DatapointType_t datapointType, GenericCallback_t callback);
 
 /**
- * @brief   Notify for a specific datapoint.
+ * @brief   Check if a datapoint range holds an event datapoint.
  *
  * @param[in]   datapointType: The datapoint type.
- * @param[in]   datapointId: The datapoint id.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   valCount: The datapoint count.
  *
- * @return  0 if successful, the error code otherwise.
+ * @return  true if at least one datapoint is an event stream, false otherwise.
+ */
+bool datastoreUtilHasEvents(DatapointType_t datapointType, uint32_t datapointId, size_t valCount);
+
+/**
+ * @brief   Get the count of events dropped because a button event ring was full.
+ *
+ * @param[in]   datapointId: The button datapoint ID.
+ *
+ * @return  The overflow count, 0 for an unknown datapoint.
+ */
+uint32_t datastoreUtilGetEventOverflowCount(uint32_t datapointId);
+
+/**
+ * @brief   Suspend the notification passes.
+ *
+ * @note    The suspensions nest, the changed datapoints stay dirty until the
+ *          last one is resumed.
+ */
+void datastoreUtilSuspendNotify(void);
+
+/**
+ * @brief   Resume the notification passes.
+ *
+ * @return  1 if the notifications are no longer suspended, 0 if still
+ *          suspended, -EALREADY if they were not suspended.
+ */
+int datastoreUtilResumeNotify(void);
+
+/**
+ * @brief   Notify the subscriptions of the datapoints changed since the last pass.
+ *
+ * @note    A subscription is called once per pass, however many of its
+ *          datapoints changed. Nothing is done while the notifications are
+ *          suspended.
+ *
+ * @return  0 if successful, the error code of the last failed subscription otherwise.
  */
-int datastoreUtilNotify(DatapointType_t datapointType, uint32_t datapointId);
+int datastoreUtilNotify(void);
 
 /**
  * @brief   Read values.
@@ -109,6 +214,169 @@ int datastoreUtilNotify(DatapointType_t datapointType, uint32_t datapointId);
  */
 int datastoreUtilReadData(DatapointType_t datapointType, uint32_t datapointId, size_t valCount, DatapointData_t values[]);
 
+/**
+ * @brief   Read a batch of value ranges.
+ *
+ * @param[in,out] descs: The read descriptors.
+ * @param[in]     descCount: The count of read descriptors.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilReadBatch(DatastoreReadDesc_t descs[], size_t descCount);
+
+/**
+ * @brief   Read values directly from the caller context.
+ *
+ * @note    The values are copied under the type write counters and the copy
+ *          is retried if a writer wrote the type during the copy.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The value count to read.
+ * @param[out]  values: The output buffer (NULL, if not needed).
+ * @param[out]  timestamps: The last change timestamps output buffer (NULL, if not needed).
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilReadDataDirect(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                                DatapointData_t values[], uint32_t timestamps[]);
+
+/**
+ * @brief   Count the datapoints that did not change for longer than a given age.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   valCount: The value count to check.
+ * @param[in]   maxAge: The maximum age in milliseconds.
+ * @param[out]  staleCount: The count of datapoints older than the maximum age.
+ *
+ * @note    The timestamps are 32-bit uptime milliseconds, ages are computed modulo 2^32:
+ *          a datapoint unchanged for more than ~49.7 days can look fresh again. A datapoint
+ *          never changed since boot keeps the timestamp 0 and is aged from boot, like one
+ *          changed during the first millisecond.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilCountOlderThan(DatapointType_t datapointType, uint32_t datapointId, size_t valCount,
+                                uint32_t maxAge, size_t *staleCount);
+
+/**
+ * @brief   Read the values changed since a cursor.
+ *
+ * @param[in,out] query: The change query.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilReadChanges(DatastoreChangeQuery_t *query);
+
+/**
+ * @brief   Validate a write in the caller context.
+ *
+ * @note    Nothing is logged, a rejected write costs a few compares against
+ *          the const limits table.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values (NULL, to only check the range).
+ * @param[in]   valCount: The values count.
+ *
+ * @return  0 if valid, -ENOTSUP for an unknown type, -ENOSPC for an invalid
+ *          range, -ERANGE for a value outside its datapoint limits.
+ */
+int datastoreUtilValidateWrite(DatapointType_t datapointType, uint32_t datapointId,
+                               const DatapointData_t values[], size_t valCount);
+
+/**
+ * @brief   Read, modify and write a value.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   op: The operation.
+ * @param[in]   operand: The operand.
+ * @param[in]   expected: The expected value of a compare-and-swap.
+ * @param[out]  oldValue: The value before the operation (NULL, if not needed).
+ * @param[out]  needToNotify: The need to notify flag.
+ *
+ * @return  0 if successful, -EAGAIN if a compare-and-swap did not match, the error code otherwise.
+ */
+int datastoreUtilModifyData(DatapointType_t datapointType, uint32_t datapointId, DatastoreRmwOp_t op,
+                            DatapointData_t operand, DatapointData_t expected, DatapointData_t *oldValue,
+                            bool *needToNotify);
+
+/**
+ * @brief   Write the staged values of a transaction.
+ *
+ * @note    Every write is validated before any is applied.
+ *
+ * @param[in]   txn: The transaction.
+ * @param[out]  needToNotify: The need to notify flag.
+ *
+ * @return  0 if successful, the error code otherwise.
+ */
+int datastoreUtilWriteTransaction(DatastoreTxn_t *txn, bool *needToNotify);
+
+/**
+ * @brief   Claim a datapoint range for an owner.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   valCount: The datapoint count.
+ *
+ * @return  0 if successful, -EBUSY if a datapoint is already claimed, the error code otherwise.
+ */
+int datastoreUtilClaimRange(DatapointType_t datapointType, uint32_t datapointId, size_t valCount);
+
+/**
+ * @brief   Release a claimed datapoint range.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   valCount: The datapoint count.
+ */
+void datastoreUtilReleaseRange(DatapointType_t datapointType, uint32_t datapointId, size_t valCount);
+
+/**
+ * @brief   Check if a datapoint range holds a claimed datapoint.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The first datapoint ID.
+ * @param[in]   valCount: The datapoint count.
+ *
+ * @return  true if at least one datapoint is claimed, false otherwise.
+ */
+bool datastoreUtilIsRangeOwned(DatapointType_t datapointType, uint32_t datapointId, size_t valCount);
+
+/**
+ * @brief   Write owned values from the owner context.
+ *
+ * @note    The write is done under the type lock, the range must be valid
+ *          and claimed by the caller. The change bookkeeping is left to
+ *          datastoreUtilProcessOwnedChanges().
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   values: The values.
+ * @param[in]   valCount: The values count.
+ *
+ * @return  true if a value changed, false otherwise.
+ */
+bool datastoreUtilWriteOwnedData(DatapointType_t datapointType, uint32_t datapointId,
+                                 DatapointData_t values[], size_t valCount);
+
+/**
+ * @brief   Check if owner writes wait for their bookkeeping.
+ *
+ * @return  true if so, false otherwise.
+ */
+bool datastoreUtilHasOwnedChanges(void);
+
+/**
+ * @brief   Do the change bookkeeping of the owner writes.
+ *
+ * @param[out]  needToNotify: The need to notify flag.
+ */
+void datastoreUtilProcessOwnedChanges(bool *needToNotify);
+
 /**
  * @brief   Write values.
  *
@@ -117,11 +385,13 @@ int datastoreUtilReadData(DatapointType_t datapointType, uint32_t datapointId, s
  * @param[in]   values: The values.
  * @param[in]   valCount: The values count.
  * @param[out]  needToNotify: The need to notify flag.
+ * @param[out]  changed: The changed bitmap, one bit per value in DATASTORE_CHANGED_WORD_BITS
+ *                       bit words (NULL, if not needed).
  *
  * @return  0 if successful, the error code otherwise.
  */
 int datastoreUtilWriteData(DatapointType_t datapointType, uint32_t datapointId,
-                           DatapointData_t values[], size_t valCount, bool *needToNotify);
+                           DatapointData_t values[], size_t valCount, bool *needToNotify, uint32_t changed[]);
 
 #endif    /* DATASTORE_SRV_UTIL */
 
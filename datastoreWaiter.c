@@ -0,0 +1,218 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreWaiter.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Waiters Implementation
+ *
+ *            Implementation of the datapoint condition waiters.
+ *
+ * @ingroup   datastore
+ * @{
+ */
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/slist.h>
+
+#include "datastoreWaiter.h"
+#include "datastoreUtil.h"
+
+/* Setting module logging */
+LOG_MODULE_DECLARE(DATASTORE_LOGGER_NAME);
+
+/**
+ * @brief   The datapoint waiter record.
+ */
+typedef struct
+{
+  sys_snode_t node;                     /**< The node in the datapoint waiter list */
+  DatastoreWaitCond_t cond;             /**< The condition */
+  DatapointData_t value;                /**< The value to compare with */
+  struct k_sem sem;                     /**< The semaphore given when the condition is satisfied */
+} DatastoreWaiter_t;
+
+/**
+ * @brief   Binary datapoint waiters.
+ */
+static sys_slist_t binaryWaiters[BINARY_DATAPOINT_COUNT];
+
+/**
+ * @brief   Button datapoint waiters.
+ */
+static sys_slist_t buttonWaiters[BUTTON_DATAPOINT_COUNT];
+
+/**
+ * @brief   Float datapoint waiters.
+ */
+static sys_slist_t floatWaiters[FLOAT_DATAPOINT_COUNT];
+
+/**
+ * @brief   Signed integer datapoint waiters.
+ */
+static sys_slist_t intWaiters[INT_DATAPOINT_COUNT];
+
+/**
+ * @brief   Multi-state datapoint waiters.
+ */
+static sys_slist_t multiStateWaiters[MULTI_STATE_DATAPOINT_COUNT];
+
+/**
+ * @brief   Unsigned integer datapoint waiters.
+ */
+static sys_slist_t uintWaiters[UINT_DATAPOINT_COUNT];
+
+/**
+ * @brief   The list of waiters for each value type.
+ */
+static sys_slist_t *waiters[DATAPOINT_TYPE_COUNT] = {binaryWaiters, buttonWaiters, floatWaiters,
+                                                     intWaiters, multiStateWaiters, uintWaiters};
+
+/**
+ * @brief   The datapoint count of each value type.
+ */
+static const size_t waiterListCounts[DATAPOINT_TYPE_COUNT] = {BINARY_DATAPOINT_COUNT, BUTTON_DATAPOINT_COUNT,
+                                                              FLOAT_DATAPOINT_COUNT, INT_DATAPOINT_COUNT,
+                                                              MULTI_STATE_DATAPOINT_COUNT, UINT_DATAPOINT_COUNT};
+
+/**
+ * @brief   The waiter lists lock.
+ */
+static struct k_spinlock waiterLock;
+
+/**
+ * @brief   Compare two values according to the datapoint type.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   lhs: The left hand side value.
+ * @param[in]   rhs: The right hand side value.
+ *
+ * @return  A negative value if lhs < rhs, 0 if they are equal, a positive value otherwise.
+ */
+static inline int compareValues(DatapointType_t datapointType, DatapointData_t lhs, DatapointData_t rhs)
+{
+  switch(datapointType)
+  {
+    case DATAPOINT_FLOAT:
+      return (lhs.floatVal > rhs.floatVal) - (lhs.floatVal < rhs.floatVal);
+    case DATAPOINT_INT:
+      return (lhs.intVal > rhs.intVal) - (lhs.intVal < rhs.intVal);
+    default:
+      return (lhs.uintVal > rhs.uintVal) - (lhs.uintVal < rhs.uintVal);
+  }
+}
+
+/**
+ * @brief   Check if a value satisfies a waiter condition.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   cond: The condition.
+ * @param[in]   current: The current datapoint value.
+ * @param[in]   value: The value to compare with.
+ *
+ * @return  true if the condition is satisfied, false otherwise.
+ */
+static bool isConditionMet(DatapointType_t datapointType, DatastoreWaitCond_t cond,
+                           DatapointData_t current, DatapointData_t value)
+{
+  int cmp = compareValues(datapointType, current, value);
+
+  switch(cond)
+  {
+    case DATASTORE_WAIT_EQUAL:
+      return cmp == 0;
+    case DATASTORE_WAIT_NOT_EQUAL:
+      return cmp != 0;
+    case DATASTORE_WAIT_LESS:
+      return cmp < 0;
+    case DATASTORE_WAIT_LESS_EQUAL:
+      return cmp <= 0;
+    case DATASTORE_WAIT_GREATER:
+      return cmp > 0;
+    case DATASTORE_WAIT_GREATER_EQUAL:
+      return cmp >= 0;
+    default:
+      return false;
+  }
+}
+
+int datastoreWaiterWait(DatapointType_t datapointType, uint32_t datapointId, DatastoreWaitCond_t cond,
+                        DatapointData_t value, k_timeout_t timeout)
+{
+  int err;
+  bool isWaiting;
+  k_spinlock_key_t key;
+  sys_slist_t *list;
+  DatapointData_t current;
+  uint32_t timestamp;
+  DatastoreWaiter_t waiter = {.cond = cond, .value = value};
+
+  if(datapointType >= DATAPOINT_TYPE_COUNT)
+    return -ENOTSUP;
+
+  if(datapointId >= waiterListCounts[datapointType] || cond >= DATASTORE_WAIT_COND_COUNT)
+    return -EINVAL;
+
+  list = waiters[datapointType] + datapointId;
+  k_sem_init(&waiter.sem, 0, 1);
+
+  /* Register before checking the value so a change in between is never missed. */
+  key = k_spin_lock(&waiterLock);
+  sys_slist_append(list, &waiter.node);
+  k_spin_unlock(&waiterLock, key);
+
+  /* The primary bank is read, a replica may still lag behind a write already checked. */
+  err = datastoreUtilReadDataDirect(datapointType, datapointId, 1, &current, &timestamp);
+  if(err == 0 && isConditionMet(datapointType, cond, current, value))
+  {
+    key = k_spin_lock(&waiterLock);
+    sys_slist_find_and_remove(list, &waiter.node);
+    k_spin_unlock(&waiterLock, key);
+    return 0;
+  }
+
+  err = k_sem_take(&waiter.sem, timeout);
+  if(err == 0)
+    return 0;
+
+  /* The service thread removes the waiter before releasing it, so it can still be satisfied here. */
+  key = k_spin_lock(&waiterLock);
+  isWaiting = sys_slist_find_and_remove(list, &waiter.node);
+  k_spin_unlock(&waiterLock, key);
+
+  return isWaiting ? err : 0;
+}
+
+void datastoreWaiterCheck(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t value)
+{
+  k_spinlock_key_t key;
+  sys_slist_t *list = waiters[datapointType] + datapointId;
+  sys_snode_t *prev = NULL;
+  sys_snode_t *node;
+  sys_snode_t *next;
+  DatastoreWaiter_t *waiter;
+
+  if(sys_slist_is_empty(list))
+    return;
+
+  key = k_spin_lock(&waiterLock);
+
+  SYS_SLIST_FOR_EACH_NODE_SAFE(list, node, next)
+  {
+    waiter = CONTAINER_OF(node, DatastoreWaiter_t, node);
+
+    if(isConditionMet(datapointType, waiter->cond, value, waiter->value))
+    {
+      sys_slist_remove(list, prev, node);
+      k_sem_give(&waiter->sem);
+    }
+    else
+    {
+      prev = node;
+    }
+  }
+
+  k_spin_unlock(&waiterLock, key);
+}
+
+/** @} */
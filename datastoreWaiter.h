@@ -0,0 +1,50 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      datastoreWaiter.h
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Waiters
+ *
+ *            Datastore service datapoint condition waiters.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#ifndef DATASTORE_SRV_WAITER
+#define DATASTORE_SRV_WAITER
+
+#include <zephyr/kernel.h>
+
+#include "datastore.h"
+
+/**
+ * @brief   Wait until a datapoint satisfies a condition.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   cond: The condition.
+ * @param[in]   value: The value to compare with.
+ * @param[in]   timeout: The wait timeout.
+ *
+ * @return  0 if the condition is satisfied, the error code otherwise.
+ */
+int datastoreWaiterWait(DatapointType_t datapointType, uint32_t datapointId, DatastoreWaitCond_t cond,
+                        DatapointData_t value, k_timeout_t timeout);
+
+/**
+ * @brief   Release the waiters of a datapoint satisfied by its new value.
+ *
+ * @note    Only the service thread calls this, after a value change.
+ *
+ * @param[in]   datapointType: The datapoint type.
+ * @param[in]   datapointId: The datapoint ID.
+ * @param[in]   value: The new datapoint value.
+ */
+void datastoreWaiterCheck(DatapointType_t datapointType, uint32_t datapointId, DatapointData_t value);
+
+#endif    /* DATASTORE_SRV_WAITER */
+
+/** @} */
@@ -0,0 +1,211 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      main.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Write Coalescing Tests
+ *
+ *            Datastore service pending write slot state machine test suite.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+
+#include "datastoreCoalesce.h"
+
+/* Setting module logging */
+LOG_MODULE_REGISTER(DATASTORE_LOGGER_NAME);
+
+/**
+ * @brief   Free every pending write slot after each test.
+ *
+ * @note    Reserved slots are cancelled, published ones discarded and the
+ *          taken ones freed by their late publication.
+ *
+ * @param[in]   fixture: The test fixture (unused).
+ */
+static void coalesceAfter(void *fixture)
+{
+  ARG_UNUSED(fixture);
+
+  for(uint32_t i = 0; i < DATASTORE_COALESCE_SLOT_COUNT; ++i)
+  {
+    datastoreCoalesceCancel(i);
+    datastoreCoalesceDiscard(i);
+    datastoreCoalescePublish(i);
+  }
+}
+
+ZTEST(datastore_coalesce, test_invalid_value_count)
+{
+  uint32_t slotId;
+  DatapointData_t values[DATASTORE_COALESCE_MAX_VALUES + 1] = {0};
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, values, 0, &slotId), -EINVAL);
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, values, DATASTORE_COALESCE_MAX_VALUES + 1, &slotId),
+                -EINVAL);
+}
+
+ZTEST(datastore_coalesce, test_merge_only_without_pending_write)
+{
+  DatapointData_t value = {.uintVal = 1};
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, NULL), -ENOENT);
+}
+
+ZTEST(datastore_coalesce, test_published_slot_takes_latest_values)
+{
+  uint32_t slotId;
+  uint32_t datapointId;
+  size_t valCount;
+  DatapointType_t datapointType;
+  DatapointData_t values[2] = {{.uintVal = 1}, {.uintVal = 2}};
+  DatapointData_t taken[DATASTORE_COALESCE_MAX_VALUES];
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 1, values, 2, &slotId), 1);
+  datastoreCoalescePublish(slotId);
+
+  values[0].uintVal = 3;
+  values[1].uintVal = 4;
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 1, values, 2, NULL), 0);
+
+  zassert_ok(datastoreCoalesceTake(slotId, &datapointType, &datapointId, taken, &valCount));
+  zassert_equal(datapointType, DATAPOINT_UINT);
+  zassert_equal(datapointId, 1);
+  zassert_equal(valCount, 2);
+  zassert_equal(taken[0].uintVal, 3);
+  zassert_equal(taken[1].uintVal, 4);
+
+  zassert_equal(datastoreCoalesceTake(slotId, &datapointType, &datapointId, taken, &valCount), -ESRCH);
+}
+
+ZTEST(datastore_coalesce, test_reserved_slot_is_not_merged)
+{
+  uint32_t firstSlotId;
+  uint32_t secondSlotId;
+  uint32_t datapointId;
+  size_t valCount;
+  DatapointType_t datapointType;
+  DatapointData_t value = {.uintVal = 1};
+  DatapointData_t taken[DATASTORE_COALESCE_MAX_VALUES];
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, &firstSlotId), 1);
+
+  value.uintVal = 2;
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, &secondSlotId), 1);
+  zassert_not_equal(firstSlotId, secondSlotId);
+
+  zassert_ok(datastoreCoalesceTake(firstSlotId, &datapointType, &datapointId, taken, &valCount));
+  zassert_equal(taken[0].uintVal, 1);
+}
+
+ZTEST(datastore_coalesce, test_partial_overlap_seals_slot)
+{
+  uint32_t firstSlotId;
+  uint32_t secondSlotId;
+  uint32_t thirdSlotId;
+  DatapointData_t values[2] = {{.uintVal = 1}, {.uintVal = 2}};
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, values, 2, &firstSlotId), 1);
+  datastoreCoalescePublish(firstSlotId);
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 1, values, 1, &secondSlotId), 1);
+  datastoreCoalescePublish(secondSlotId);
+
+  /* The first slot must not be updated ahead of the partial write queued after it. */
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, values, 2, &thirdSlotId), 1);
+  zassert_not_equal(thirdSlotId, firstSlotId);
+  zassert_not_equal(thirdSlotId, secondSlotId);
+}
+
+ZTEST(datastore_coalesce, test_seal_stops_merging)
+{
+  uint32_t slotId;
+  DatapointData_t value = {.floatVal = 1.0f};
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_FLOAT, 2, &value, 1, &slotId), 1);
+  datastoreCoalescePublish(slotId);
+
+  datastoreCoalesceSeal(DATAPOINT_FLOAT, 2, 1);
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_FLOAT, 2, &value, 1, NULL), -ENOENT);
+}
+
+ZTEST(datastore_coalesce, test_other_type_is_not_merged)
+{
+  uint32_t slotId;
+  DatapointData_t value = {.uintVal = 1};
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, &slotId), 1);
+  datastoreCoalescePublish(slotId);
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_INT, 0, &value, 1, NULL), -ENOENT);
+}
+
+ZTEST(datastore_coalesce, test_take_before_publish)
+{
+  uint32_t slotId;
+  uint32_t newSlotId;
+  uint32_t datapointId;
+  size_t valCount;
+  DatapointType_t datapointType;
+  DatapointData_t value = {.uintVal = 1};
+  DatapointData_t taken[DATASTORE_COALESCE_MAX_VALUES];
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, &slotId), 1);
+  zassert_ok(datastoreCoalesceTake(slotId, &datapointType, &datapointId, taken, &valCount));
+
+  /* Taken but not published yet, the slot cannot be reused. */
+  for(uint32_t i = 0; i < DATASTORE_COALESCE_SLOT_COUNT - 1; ++i)
+  {
+    zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, i + 1, &value, 1, &newSlotId), 1);
+    zassert_not_equal(newSlotId, slotId);
+  }
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, &newSlotId), -ENOSPC);
+
+  datastoreCoalescePublish(slotId);
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_UINT, 0, &value, 1, &newSlotId), 1);
+  zassert_equal(newSlotId, slotId);
+}
+
+ZTEST(datastore_coalesce, test_cancel_frees_reserved_slot)
+{
+  uint32_t slotId;
+  uint32_t datapointId;
+  size_t valCount;
+  DatapointType_t datapointType;
+  DatapointData_t value = {.intVal = -1};
+  DatapointData_t taken[DATASTORE_COALESCE_MAX_VALUES];
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_INT, 0, &value, 1, &slotId), 1);
+  datastoreCoalesceCancel(slotId);
+
+  zassert_equal(datastoreCoalesceTake(slotId, &datapointType, &datapointId, taken, &valCount), -ESRCH);
+}
+
+ZTEST(datastore_coalesce, test_discard_frees_published_slot)
+{
+  uint32_t slotId;
+  uint32_t datapointId;
+  size_t valCount;
+  DatapointType_t datapointType;
+  DatapointData_t value = {.intVal = -1};
+  DatapointData_t taken[DATASTORE_COALESCE_MAX_VALUES];
+
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_INT, 0, &value, 1, &slotId), 1);
+  datastoreCoalescePublish(slotId);
+  datastoreCoalesceDiscard(slotId);
+
+  zassert_equal(datastoreCoalesceTake(slotId, &datapointType, &datapointId, taken, &valCount), -ESRCH);
+  zassert_equal(datastoreCoalesceWrite(DATAPOINT_INT, 0, &value, 1, NULL), -ENOENT);
+}
+
+ZTEST_SUITE(datastore_coalesce, NULL, NULL, NULL, coalesceAfter, NULL);
+
+/** @} */
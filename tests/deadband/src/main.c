@@ -0,0 +1,252 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      main.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Deadband Tests
+ *
+ *            Datastore service notification deadband and hysteresis test suite.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#include <zephyr/ztest.h>
+
+#include "datastore.h"
+
+/**
+ * @brief   The datastore service thread priority.
+ */
+#define TEST_DATASTORE_PRIORITY                                   (1)
+
+/**
+ * @brief   The write response queue.
+ */
+K_MSGQ_DEFINE(testResQueue, sizeof(int), 1, 4);
+
+/**
+ * @brief   The absolute deadband float notification count.
+ */
+static atomic_t floatAbsNotifyCount;
+
+/**
+ * @brief   The relative deadband float notification count.
+ */
+static atomic_t floatRelNotifyCount;
+
+/**
+ * @brief   The signed integer notification count.
+ */
+static atomic_t intNotifyCount;
+
+/**
+ * @brief   The unsigned integer notification count.
+ */
+static atomic_t uintNotifyCount;
+
+/**
+ * @brief   Count the absolute deadband float notifications.
+ *
+ * @param[in]   values: The subscribed values.
+ * @param[in]   valCount: The subscribed value count (unused).
+ *
+ * @return  0.
+ */
+static int onFloatAbsNotify(float values[], size_t *valCount)
+{
+  ARG_UNUSED(values);
+  ARG_UNUSED(valCount);
+
+  atomic_inc(&floatAbsNotifyCount);
+
+  return 0;
+}
+
+/**
+ * @brief   Count the relative deadband float notifications.
+ *
+ * @param[in]   values: The subscribed values.
+ * @param[in]   valCount: The subscribed value count (unused).
+ *
+ * @return  0.
+ */
+static int onFloatRelNotify(float values[], size_t *valCount)
+{
+  ARG_UNUSED(values);
+  ARG_UNUSED(valCount);
+
+  atomic_inc(&floatRelNotifyCount);
+
+  return 0;
+}
+
+/**
+ * @brief   Count the signed integer notifications.
+ *
+ * @param[in]   values: The subscribed values.
+ * @param[in]   valCount: The subscribed value count (unused).
+ *
+ * @return  0.
+ */
+static int onIntNotify(int32_t values[], size_t *valCount)
+{
+  ARG_UNUSED(values);
+  ARG_UNUSED(valCount);
+
+  atomic_inc(&intNotifyCount);
+
+  return 0;
+}
+
+/**
+ * @brief   Count the unsigned integer notifications.
+ *
+ * @param[in]   values: The subscribed values.
+ * @param[in]   valCount: The subscribed value count (unused).
+ *
+ * @return  0.
+ */
+static int onUintNotify(uint32_t values[], size_t *valCount)
+{
+  ARG_UNUSED(values);
+  ARG_UNUSED(valCount);
+
+  atomic_inc(&uintNotifyCount);
+
+  return 0;
+}
+
+/**
+ * @brief   The datapoint subscriptions.
+ */
+static DatastoreFloatSub_t floatAbsSub = {.datapointId = FLOAT_ABS_DATAPOINT, .valCount = 1,
+                                          .callback = onFloatAbsNotify};
+static DatastoreFloatSub_t floatRelSub = {.datapointId = FLOAT_REL_DATAPOINT, .valCount = 1,
+                                          .callback = onFloatRelNotify};
+static DatastoreIntSub_t intSub = {.datapointId = INT_HYST_DATAPOINT, .valCount = 1, .callback = onIntNotify};
+static DatastoreUintSub_t uintSub = {.datapointId = UINT_HYST_DATAPOINT, .valCount = 1, .callback = onUintNotify};
+
+/**
+ * @brief   Start the datastore service once for the suite.
+ *
+ * @return  NULL, the suite has no fixture.
+ */
+static void *deadbandSetup(void)
+{
+  k_tid_t threadId;
+  int32_t intVal;
+  size_t maxSubs[DATAPOINT_TYPE_COUNT] = {[DATAPOINT_FLOAT] = 2, [DATAPOINT_INT] = 1, [DATAPOINT_UINT] = 1};
+
+  zassert_ok(datastoreInit(maxSubs, DATASTORE_MSG_INLINE_VALUES, TEST_DATASTORE_PRIORITY, &threadId));
+  zassert_ok(datastoreSubscribeFloat(&floatAbsSub));
+  zassert_ok(datastoreSubscribeFloat(&floatRelSub));
+  zassert_ok(datastoreSubscribeInt(&intSub));
+  zassert_ok(datastoreSubscribeUint(&uintSub));
+  k_thread_start(threadId);
+
+  /* Served after the initial notifications, none of them lands in a test. */
+  zassert_ok(datastoreReadInt(INT_HYST_DATAPOINT, 1, &testResQueue, &intVal));
+
+  return NULL;
+}
+
+/**
+ * @brief   Start each test with no notification.
+ *
+ * @param[in]   fixture: The test fixture (unused).
+ */
+static void deadbandBefore(void *fixture)
+{
+  ARG_UNUSED(fixture);
+
+  atomic_clear(&floatAbsNotifyCount);
+  atomic_clear(&floatRelNotifyCount);
+  atomic_clear(&intNotifyCount);
+  atomic_clear(&uintNotifyCount);
+}
+
+/**
+ * @brief   Write a float and check if it was notified.
+ *
+ * @param[in]   datapointId: The float datapoint ID.
+ * @param[in]   count: The notification count of the datapoint.
+ * @param[in]   value: The value to write.
+ * @param[in]   isNotified: The expected notification.
+ */
+static void checkFloatWrite(uint32_t datapointId, atomic_t *count, float value, bool isNotified)
+{
+  float stored;
+  atomic_val_t before = atomic_get(count);
+
+  zassert_ok(datastoreWriteFloat(datapointId, &value, 1, &testResQueue));
+
+  /* Stored either way, only the notification is suppressed. */
+  zassert_ok(datastoreReadFloatDirect(datapointId, 1, &stored));
+  zassert_equal(stored, value);
+  zassert_equal(atomic_get(count) - before, isNotified ? 1 : 0, "write of %d/1000",
+                (int)(value * 1000.0f));
+}
+
+ZTEST(datastore_deadband, test_float_absolute_deadband)
+{
+  checkFloatWrite(FLOAT_ABS_DATAPOINT, &floatAbsNotifyCount, 0.3f, false);
+  checkFloatWrite(FLOAT_ABS_DATAPOINT, &floatAbsNotifyCount, 0.6f, true);
+  checkFloatWrite(FLOAT_ABS_DATAPOINT, &floatAbsNotifyCount, 0.9f, false);
+  checkFloatWrite(FLOAT_ABS_DATAPOINT, &floatAbsNotifyCount, 0.2f, false);
+  checkFloatWrite(FLOAT_ABS_DATAPOINT, &floatAbsNotifyCount, 1.2f, true);
+}
+
+ZTEST(datastore_deadband, test_float_relative_deadband)
+{
+  checkFloatWrite(FLOAT_REL_DATAPOINT, &floatRelNotifyCount, 105.0f, false);
+  checkFloatWrite(FLOAT_REL_DATAPOINT, &floatRelNotifyCount, 111.0f, true);
+  checkFloatWrite(FLOAT_REL_DATAPOINT, &floatRelNotifyCount, 101.0f, false);
+  checkFloatWrite(FLOAT_REL_DATAPOINT, &floatRelNotifyCount, 95.0f, true);
+}
+
+ZTEST(datastore_deadband, test_int_hysteresis)
+{
+  const struct
+  {
+    int32_t value;
+    bool isNotified;
+  } steps[] = {{1, false}, {2, false}, {3, true}, {4, true}, {3, false}, {2, false}, {1, true}, {0, true}};
+  int32_t value;
+  atomic_val_t before;
+
+  for(size_t i = 0; i < ARRAY_SIZE(steps); ++i)
+  {
+    value = steps[i].value;
+    before = atomic_get(&intNotifyCount);
+
+    zassert_ok(datastoreWriteInt(INT_HYST_DATAPOINT, &value, 1, &testResQueue));
+    zassert_equal(atomic_get(&intNotifyCount) - before, steps[i].isNotified ? 1 : 0, "step %zu", i);
+  }
+}
+
+ZTEST(datastore_deadband, test_uint_hysteresis)
+{
+  const struct
+  {
+    uint32_t value;
+    bool isNotified;
+  } steps[] = {{12, false}, {9, false}, {7, true}, {6, true}, {8, false}, {9, true}};
+  uint32_t value;
+  atomic_val_t before;
+
+  for(size_t i = 0; i < ARRAY_SIZE(steps); ++i)
+  {
+    value = steps[i].value;
+    before = atomic_get(&uintNotifyCount);
+
+    zassert_ok(datastoreWriteUint(UINT_HYST_DATAPOINT, &value, 1, &testResQueue));
+    zassert_equal(atomic_get(&uintNotifyCount) - before, steps[i].isNotified ? 1 : 0, "step %zu", i);
+  }
+}
+
+ZTEST_SUITE(datastore_deadband, NULL, deadbandSetup, deadbandBefore, NULL, NULL);
+
+/** @} */
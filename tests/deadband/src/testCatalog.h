@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      testCatalog.h
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Deadband Test Catalog
+ *
+ *            Datapoint catalog of the deadband and hysteresis test suite,
+ *            included by datastoreMeta.h in place of the default one.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#ifndef DATASTORE_TEST_CATALOG
+#define DATASTORE_TEST_CATALOG
+
+/**
+ * @brief   Binary datapoint information X-macro.
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
+ */
+#define DATASTORE_BINARY_DATAPOINTS       X(BINARY_TEST_DATAPOINT,   0, false, 0, 0, 1)
+
+/**
+ * @brief   Button datapoint information X-macro.
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
+ */
+#define DATASTORE_BUTTON_DATAPOINTS       X(BUTTON_TEST_DATAPOINT,   0, 0, 0, BUTTON_DEPRESSED, BUTTON_LONG_PRESSED)
+
+/**
+ * @brief   Float datapoint information X-macro.
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
+ *          An absolute 0.5 deadband and a relative 10% one.
+ */
+#define DATASTORE_FLOAT_DATAPOINTS        X(FLOAT_ABS_DATAPOINT,     0, 0.0f, 0.5f, -FLT_MAX, FLT_MAX) \
+                                          X(FLOAT_REL_DATAPOINT,     DATAPOINT_FLAG_BAND_RELATIVE_MASK, 100.0f, 0.1f, -FLT_MAX, FLT_MAX)
+
+/**
+ * @brief   Signed integer datapoint information X-macro.
+ * @note    X(datapoint ID, option flag, default value, hysteresis, minimum value, maximum value)
+ */
+#define DATASTORE_INT_DATAPOINTS          X(INT_HYST_DATAPOINT,      0, 0, 2, INT32_MIN, INT32_MAX)
+
+/**
+ * @brief   Multi-state datapoint information X-macro.
+ * @note    X(datapoint ID, option flag, default value, deadband, minimum value, maximum value)
+ */
+#define DATASTORE_MULTI_STATE_DATAPOINTS  X(MULTI_STATE_TEST_DATAPOINT, 0, 0, 0, 0, 3)
+
+/**
+ * @brief   Unsigned integer datapoint information X-macro.
+ * @note    X(datapoint ID, option flag, default value, hysteresis, minimum value, maximum value)
+ */
+#define DATASTORE_UINT_DATAPOINTS         X(UINT_HYST_DATAPOINT,     0, 10, 2, 0, UINT32_MAX)
+
+#endif    /* DATASTORE_TEST_CATALOG */
+
+/** @} */
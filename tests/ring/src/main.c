@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      main.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Ring Tests
+ *
+ *            Datastore service multi-producer/single-consumer ring test suite.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+
+#include "datastoreMeta.h"
+#include "datastoreRing.h"
+
+/* Setting module logging */
+LOG_MODULE_REGISTER(DATASTORE_LOGGER_NAME);
+
+/**
+ * @brief   The test ring slot count.
+ */
+#define TEST_RING_SLOT_COUNT                                      (4)
+
+/**
+ * @brief   The test ring doorbell.
+ */
+DATASTORE_DOORBELL_DEFINE(testDoorbell);
+
+/**
+ * @brief   The test ring.
+ */
+DATASTORE_RING_DEFINE(testRing, sizeof(uint32_t), TEST_RING_SLOT_COUNT, &testDoorbell);
+
+/**
+ * @brief   Reset the ring and its doorbell before each test.
+ *
+ * @param[in]   fixture: The test fixture (unused).
+ */
+static void ringBefore(void *fixture)
+{
+  ARG_UNUSED(fixture);
+
+  datastoreRingInit(&testRing);
+  datastoreDoorbellCancel(&testDoorbell);
+  k_sem_reset(&testDoorbell.sem);
+}
+
+ZTEST(datastore_ring, test_get_from_empty_ring)
+{
+  uint32_t element;
+
+  zassert_true(datastoreRingIsEmpty(&testRing));
+  zassert_equal(datastoreRingUsedCount(&testRing), 0);
+  zassert_equal(datastoreRingGet(&testRing, &element), -ENOMSG);
+}
+
+ZTEST(datastore_ring, test_elements_come_out_in_order)
+{
+  uint32_t element;
+
+  for(uint32_t i = 0; i < TEST_RING_SLOT_COUNT; ++i)
+    zassert_ok(datastoreRingPut(&testRing, &i));
+
+  for(uint32_t i = 0; i < TEST_RING_SLOT_COUNT; ++i)
+  {
+    zassert_ok(datastoreRingGet(&testRing, &element));
+    zassert_equal(element, i);
+  }
+
+  zassert_true(datastoreRingIsEmpty(&testRing));
+}
+
+ZTEST(datastore_ring, test_put_into_full_ring)
+{
+  uint32_t element = 0;
+
+  for(uint32_t i = 0; i < TEST_RING_SLOT_COUNT; ++i)
+    zassert_ok(datastoreRingPut(&testRing, &i));
+
+  zassert_equal(datastoreRingUsedCount(&testRing), TEST_RING_SLOT_COUNT);
+  zassert_equal(datastoreRingPut(&testRing, &element), -ENOMSG);
+
+  zassert_ok(datastoreRingGet(&testRing, &element));
+  zassert_equal(element, 0);
+  zassert_ok(datastoreRingPut(&testRing, &element));
+}
+
+ZTEST(datastore_ring, test_positions_wrap_around)
+{
+  uint32_t element;
+
+  for(uint32_t i = 0; i < 3 * TEST_RING_SLOT_COUNT + 1; ++i)
+  {
+    zassert_ok(datastoreRingPut(&testRing, &i));
+    zassert_equal(datastoreRingUsedCount(&testRing), 1);
+    zassert_ok(datastoreRingGet(&testRing, &element));
+    zassert_equal(element, i);
+  }
+
+  zassert_true(datastoreRingIsEmpty(&testRing));
+}
+
+ZTEST(datastore_ring, test_put_wakes_armed_consumer)
+{
+  uint32_t element = 7;
+
+  datastoreDoorbellArm(&testDoorbell);
+  zassert_ok(datastoreRingPut(&testRing, &element));
+  zassert_ok(datastoreDoorbellWait(&testDoorbell, K_NO_WAIT));
+}
+
+ZTEST(datastore_ring, test_put_leaves_awake_consumer_alone)
+{
+  uint32_t element = 7;
+
+  zassert_ok(datastoreRingPut(&testRing, &element));
+  zassert_equal(datastoreDoorbellWait(&testDoorbell, K_NO_WAIT), -EBUSY);
+}
+
+ZTEST_SUITE(datastore_ring, NULL, NULL, ringBefore, NULL, NULL);
+
+/** @} */
@@ -0,0 +1,191 @@
+/**
+ * Copyright (C) 2026 by Electronya
+ *
+ * @file      main.c
+ * @author    jbacon
+ * @date      2026-10-16
+ * @brief     Datastore Transaction Tests
+ *
+ *            Datastore service write transaction test suite.
+ *
+ * @ingroup   datastore
+ *
+ * @{
+ */
+
+#include <zephyr/ztest.h>
+
+#include "datastore.h"
+
+/**
+ * @brief   The datastore service thread priority.
+ */
+#define TEST_DATASTORE_PRIORITY                                   (1)
+
+/**
+ * @brief   The transaction response queue.
+ */
+K_MSGQ_DEFINE(testResQueue, sizeof(int), 1, 4);
+
+/**
+ * @brief   The transaction under test.
+ */
+static DatastoreTxn_t testTxn;
+
+/**
+ * @brief   The signed integer subscription notification count.
+ */
+static atomic_t intNotifyCount;
+
+/**
+ * @brief   Count the signed integer notifications.
+ *
+ * @param[in]   values: The subscribed values.
+ * @param[in]   valCount: The subscribed value count (unused).
+ *
+ * @return  0.
+ */
+static int onIntNotify(int32_t values[], size_t *valCount)
+{
+  ARG_UNUSED(values);
+  ARG_UNUSED(valCount);
+
+  atomic_inc(&intNotifyCount);
+
+  return 0;
+}
+
+/**
+ * @brief   The signed integer subscription, the first two datapoints.
+ */
+static DatastoreIntSub_t intSub = {.datapointId = INT_FIRST_DATAPOINT, .valCount = 2, .callback = onIntNotify};
+
+/**
+ * @brief   Start the datastore service once for the suite.
+ *
+ * @return  NULL, the suite has no fixture.
+ */
+static void *txnSetup(void)
+{
+  k_tid_t threadId;
+  int32_t intVal;
+  size_t maxSubs[DATAPOINT_TYPE_COUNT] = {[DATAPOINT_INT] = 1};
+
+  zassert_ok(datastoreInit(maxSubs, DATASTORE_MSG_INLINE_VALUES, TEST_DATASTORE_PRIORITY, &threadId));
+  zassert_ok(datastoreSubscribeInt(&intSub));
+  k_thread_start(threadId);
+
+  /* Served after the initial notifications, none of them lands in a test. */
+  zassert_ok(datastoreReadInt(INT_FIRST_DATAPOINT, 1, &testResQueue, &intVal));
+
+  return NULL;
+}
+
+/**
+ * @brief   Start each test with an empty transaction and no notification.
+ *
+ * @param[in]   fixture: The test fixture (unused).
+ */
+static void txnBefore(void *fixture)
+{
+  ARG_UNUSED(fixture);
+
+  datastoreTxnBegin(&testTxn);
+  k_msgq_purge(&testResQueue);
+  atomic_clear(&intNotifyCount);
+}
+
+ZTEST(datastore_txn, test_empty_commit)
+{
+  zassert_ok(datastoreTxnCommit(&testTxn, &testResQueue));
+}
+
+ZTEST(datastore_txn, test_commit_applies_every_write)
+{
+  int32_t ints[2];
+  uint32_t uintVal;
+  DatapointData_t intValues[2] = {{.intVal = 10}, {.intVal = 11}};
+  DatapointData_t uintValue = {.uintVal = 42};
+
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_INT, INT_FIRST_DATAPOINT, intValues, 2));
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_UINT, UINT_SECOND_DATAPOINT, &uintValue, 1));
+  zassert_ok(datastoreTxnCommit(&testTxn, &testResQueue));
+
+  zassert_ok(datastoreReadIntDirect(INT_FIRST_DATAPOINT, 2, ints));
+  zassert_equal(ints[0], 10);
+  zassert_equal(ints[1], 11);
+
+  zassert_ok(datastoreReadUintDirect(UINT_SECOND_DATAPOINT, 1, &uintVal));
+  zassert_equal(uintVal, 42);
+}
+
+ZTEST(datastore_txn, test_commit_notifies_once)
+{
+  DatapointData_t first = {.intVal = 20};
+  DatapointData_t second = {.intVal = 21};
+
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_INT, INT_FIRST_DATAPOINT, &first, 1));
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_INT, INT_SECOND_DATAPOINT, &second, 1));
+  zassert_ok(datastoreTxnCommit(&testTxn, &testResQueue));
+
+  zassert_equal(atomic_get(&intNotifyCount), 1);
+}
+
+ZTEST(datastore_txn, test_invalid_stage_fails_commit)
+{
+  int32_t intVal;
+  DatapointData_t valid = {.intVal = 30};
+  DatapointData_t outOfRange = {.uintVal = MULTI_STATE_FIRST_STATE_COUNT};
+
+  zassert_ok(datastoreReadIntDirect(INT_THIRD_DATAPOINT, 1, &intVal));
+  zassert_not_equal(intVal, 30);
+
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_INT, INT_THIRD_DATAPOINT, &valid, 1));
+  zassert_equal(datastoreTxnStage(&testTxn, DATAPOINT_MULTI_STATE, MULTI_STATE_FIRST_DATAPOINT, &outOfRange, 1),
+                -ERANGE);
+
+  /* The first staging error is kept, nothing is written. */
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_INT, INT_THIRD_DATAPOINT, &valid, 1));
+  zassert_equal(datastoreTxnCommit(&testTxn, &testResQueue), -ERANGE);
+
+  zassert_ok(datastoreReadIntDirect(INT_THIRD_DATAPOINT, 1, &intVal));
+  zassert_not_equal(intVal, 30);
+}
+
+ZTEST(datastore_txn, test_staging_past_capacity)
+{
+  DatapointData_t value = {.uintVal = 1};
+
+  for(uint32_t i = 0; i < DATASTORE_TXN_MAX_WRITES; ++i)
+    zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_UINT, UINT_FIRST_DATAPOINT, &value, 1));
+
+  zassert_equal(datastoreTxnStage(&testTxn, DATAPOINT_UINT, UINT_FIRST_DATAPOINT, &value, 1), -ENOSPC);
+  zassert_equal(datastoreTxnCommit(&testTxn, &testResQueue), -ENOSPC);
+}
+
+ZTEST(datastore_txn, test_rejected_write_rolls_back_transaction)
+{
+  int32_t intVal;
+  uint32_t uintVal;
+  DatastoreOwner_t owner = {0};
+  DatapointData_t intValue = {.intVal = 40};
+  DatapointData_t uintValue = {.uintVal = 40};
+
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_UINT, UINT_THIRD_DATAPOINT, &uintValue, 1));
+  zassert_ok(datastoreTxnStage(&testTxn, DATAPOINT_INT, INT_FOURTH_DATAPOINT, &intValue, 1));
+
+  /* Claimed once staged, the service rejects the transaction as a whole. */
+  zassert_ok(datastoreOwnerClaim(&owner, DATAPOINT_INT, INT_FOURTH_DATAPOINT, 1));
+  zassert_equal(datastoreTxnCommit(&testTxn, &testResQueue), -EPERM);
+  datastoreOwnerRelease(&owner);
+
+  zassert_ok(datastoreReadUintDirect(UINT_THIRD_DATAPOINT, 1, &uintVal));
+  zassert_not_equal(uintVal, 40);
+  zassert_ok(datastoreReadIntDirect(INT_FOURTH_DATAPOINT, 1, &intVal));
+  zassert_not_equal(intVal, 40);
+  zassert_equal(atomic_get(&intNotifyCount), 0);
+}
+
+ZTEST_SUITE(datastore_txn, NULL, txnSetup, txnBefore, NULL, NULL);
+
+/** @} */